@@ -0,0 +1,230 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+using namespace std;
+
+// Runs the images of a batch of compiled programs in emulators on a pool of workers, each capped by the same budget
+// What each program printed, how long it ran, and why it stopped go into a JSON report
+class BatchRunner
+{
+    public:
+        // Default constructor for the BatchRunner class (0 jobs is one worker for every core)
+        BatchRunner(const int jobCount, const long long maxSteps, const long long maxCycles)
+        {
+            this->jobs = jobCount;
+            this->stepBudget = maxSteps;
+            this->cycleBudget = maxCycles;
+        }
+
+        // Adds a program that compiled (image has the runtime environment) or the error that stopped it (image is empty)
+        void add(const string file, const int progNum, const string compileResult, const vector<string> image)
+        {
+            programs.emplace_back(file, progNum, image);
+            if (image.empty())
+            {
+                programs.back().exitReason = compileResult;
+            }
+        }
+
+        // Runs every compiled program on the workers
+        void run()
+        {
+            auto start = chrono::steady_clock::now();
+            this->workersUsed = runOnWorkers(jobs, programs.size(), [this](const int index)
+            {
+                runProgram(programs[index]);
+            });
+            auto end = chrono::steady_clock::now();
+            milliseconds = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        }
+
+        // Calls a task for every index up to count on a pool of workers, each taking the next index that hasn't been taken
+        // Returns how many workers there were (0 jobs is one for every core)
+        static int runOnWorkers(int jobs, const int count, const function<void(int)>& task)
+        {
+            if (jobs <= 0)
+            {
+                jobs = max(1, (int)thread::hardware_concurrency());
+            }
+
+            atomic<int> next(0);
+            vector<thread> workers;
+            int workerCount = min(jobs, max(1, count));
+            for (int i = 0; i < workerCount; i++)
+            {
+                workers.emplace_back([&next, &task, count]()
+                {
+                    for (int index = next++; index < count; index = next++)
+                    {
+                        task(index);
+                    }
+                });
+            }
+            for (thread& worker : workers)
+            {
+                worker.join();
+            }
+            return workerCount;
+        }
+
+        // Logs how many programs stopped for each reason
+        void printSummary()
+        {
+            map<string, int> reasons;
+            for (Program& program : programs)
+            {
+                reasons[program.exitReason]++;
+            }
+
+            log("INFO", "Ran " + to_string(programs.size()) + " program(s) on " + to_string(workersUsed) + " worker(s) in " + to_string(milliseconds) + " ms");
+            for (const auto& entry : reasons)
+            {
+                log("INFO", to_string(entry.second) + " program(s): " + entry.first);
+            }
+        }
+
+        // Writes every program's results as a JSON array, returns false if it couldn't be written
+        bool writeReport(const string path)
+        {
+            ofstream file(path);
+            if (!file)
+            {
+                log("ERROR", "Could not write the batch report to " + path);
+                return false;
+            }
+
+            file << "[" << endl;
+            for (int i = 0, n = programs.size(); i < n; i++)
+            {
+                Program& program = programs[i];
+                file << "  {\"file\": " << quote(program.file)
+                     << ", \"program\": " << program.number
+                     << ", \"exit\": " << quote(program.exitReason)
+                     << ", \"steps\": " << program.steps
+                     << ", \"cycles\": " << program.cycles
+                     << ", \"output\": " << quote(program.output)
+                     << ", \"error\": " << quote(program.errorMessage) << "}";
+                if (i < n - 1)
+                {
+                    file << ",";
+                }
+                file << endl;
+            }
+            file << "]" << endl;
+
+            log("INFO", "Batch report written to " + path);
+            return true;
+        }
+
+        // Quotes a string for JSON, escaping anything that can't go in it as is
+        static string quote(const string str)
+        {
+            stringstream result;
+            result << "\"";
+            for (unsigned char c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    result << "\\" << c;
+                }
+                else if (c < 0x20 || c >= 0x7F)
+                {
+                    result << "\\u" << hex << setw(4) << setfill('0') << (int)c << dec;
+                }
+                else
+                {
+                    result << c;
+                }
+            }
+            result << "\"";
+            return result.str();
+        }
+
+    private:
+        // Default members
+        int jobs;
+        long long stepBudget;
+        long long cycleBudget;
+
+        // A program in the batch and the results of running it
+        struct Program
+        {
+            string file;
+            int number;
+            vector<string> image;
+            string exitReason;
+            string output;
+            string errorMessage;
+            long long steps;
+            long long cycles;
+
+            // Constructor for struct
+            Program(const string f, const int n, const vector<string> i)
+            {
+                file = f;
+                number = n;
+                image = i;
+                steps = 0;
+                cycles = 0;
+            }
+        };
+
+        // Each worker only writes to the programs it took, so they don't need a lock
+        vector<Program> programs;
+
+        // Timing of the last run
+        long long milliseconds = 0;
+        int workersUsed = 0;
+
+        // Runs a single program in its own emulator (programs that didn't compile are skipped)
+        void runProgram(Program& program)
+        {
+            if (program.image.empty())
+            {
+                return;
+            }
+
+            Emulator emulator = Emulator(program.image);
+            emulator.setBudget(stepBudget, cycleBudget);
+            emulator.run();
+
+            program.exitReason = emulator.getExitReason();
+            program.output = emulator.getOutput();
+            program.errorMessage = emulator.getErrorMessage();
+            program.steps = emulator.getSteps();
+            program.cycles = emulator.getCycles();
+
+            // The image isn't needed anymore
+            program.image.clear();
+        }
+
+        // Logging function for the batch runner
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Batch - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
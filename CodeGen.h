@@ -8,31 +8,92 @@ class CodeGen
 {
     public:
         // Default constructor for the CodeGen class
-        CodeGen(const int progNum, Tree* progAST, SymbolTable* progSymTable)
+        CodeGen(const int progNum, Tree* progAST, SymbolTable* progSymTable, Options progOptions = Options())
         {
             this->programNumber = progNum;
             this->myAST = progAST;
             this->mySymTable = progSymTable;
+            this->options = progOptions;
+            this->target = options.getTarget();
 
             this->currentHash = mySymTable->getRoot();
-            
-            // Fill runtime environment will all 0x00
-            fill(runEnv.begin(), runEnv.end(), "00");
+
+            // Size the runtime environment for the target and fill it with all 0x00
+            runEnv.assign(target.getMemorySize(), "00");
+            heapVal = target.getScratchAddress();
         }
 
         // Starts generating code
         void generate()
         {
-            // Begin each program with loading accumulator with 0
-            // This fixes an issue where while loop at beginning will break in OS if pc jumps to 0x00
-            write("A9");
-            write("00");
+            // Branches that are out of range get trampolines on the next attempt, so regenerate until they all fit
+            for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++)
+            {
+                reset();
+                branchOutOfRange = false;
+
+                // Go through the three-address IR instead of generating straight from the AST (unless the IR couldn't fit its branches)
+                if (options.usesIR() && !irFailed)
+                {
+                    selectFromIR();
+                }
+                else
+                {
+                    // Begin each program with loading accumulator with 0
+                    // This fixes an issue where while loop at beginning will break in OS if pc jumps to 0x00
+                    emit("A9", "00");
 
-            // Traverse tree to generate code
-            traverse(myAST->getRoot());
+                    // Traverse tree to generate code
+                    traverse(myAST->getRoot());
 
-            // Create break at the end of the code
-            write("00");
+                    // Create break at the end of the code
+                    emit("00");
+                }
+
+                // Every string is known now, so they can be placed in the heap
+                if (!error)
+                {
+                    layoutStrings();
+                }
+
+                if (error)
+                {
+                    break;
+                }
+
+                // Optimize the instructions before they are placed and backpatched
+                if (options.isEnabled("peephole"))
+                {
+                    Peephole peephole = Peephole(code);
+                    peephole.optimize();
+                }
+
+                // Place the instructions in the runtime environment
+                assemble();
+
+                // Hops between IR instructions couldn't bring every branch in range, so start over from the AST, which has trampolines
+                if (branchOutOfRange && !error && options.usesIR() && !irFailed)
+                {
+                    log("DEBUG", "IR: Branch out of range with no room for a hop, generating from the AST instead");
+                    irFailed = true;
+                    farBranches.clear();
+                    continue;
+                }
+
+                if (!branchOutOfRange || error)
+                {
+                    break;
+                }
+                log("DEBUG", "Branch out of range, regenerating with trampolines for " + to_string(farBranches.size()) + " block(s)");
+            }
+
+            // Give up if trampolines couldn't bring every branch in range
+            if (branchOutOfRange && !error)
+            {
+                error = true;
+                errorMessage = "Branch out of range: A single statement is too large to branch over";
+                tooFar = true;
+            }
 
             // Backpatch temporary values if there were no errors
             if (!error)
@@ -50,7 +111,7 @@ class CodeGen
             if (!error)
             {
                 // Divide output every eight lines
-                for (int i = 0x00; i < 0x100; i++)
+                for (int i = 0x00, n = runEnv.size(); i < n; i++)
                 {
                     if (i != 0x00 && i % 0x08 == 0x00)
                     {
@@ -64,19 +125,112 @@ class CodeGen
             }
             else 
             {
-                log("ERROR", "Memory Overflow: Generated code exceeds available address space (256 bytes)");
+                log("ERROR", errorMessage);
                 log("INFO", "Code Generation completed with an error.");
             }
         }
 
+        // Returns whether or not there was an error in code generation
+        bool hasError()
+        {
+            return this->error;
+        }
+
+        // Getter for the runtime environment (what the hex dump prints)
+        vector<string> getImage()
+        {
+            return this->runEnv;
+        }
+
+        // Getter for the generated instructions (each one knows its address and the AST Node it came from)
+        vector<Instruction> getCode()
+        {
+            return this->code;
+        }
+
+        // Returns whether or not code generation failed because the program doesn't fit in memory
+        bool hasOverflowed()
+        {
+            return this->error && this->overflow;
+        }
+
+        // Returns whether or not a smaller level could still generate the program (it didn't fit, or a statement was too large to branch over)
+        bool canRetrySmaller()
+        {
+            return this->error && (this->overflow || this->tooFar);
+        }
+
+        // Bytes taken up by the code, static data, and heap (the heap includes the scratch cell that ends its first string)
+        int getCodeSize()
+        {
+            int size = 0;
+            for (Instruction& instruction : code)
+            {
+                size += instruction.getSize();
+            }
+            return size;
+        }
+
+        int getStaticSize()
+        {
+            return this->staticData.size();
+        }
+
+        int getHeapSize()
+        {
+            return target.getScratchAddress() - this->heapVal;
+        }
+
+        // Names of the static slots in the order they come after the code (variables are name@scope, temporary values go by what they were made for)
+        vector<string> getStaticNames()
+        {
+            vector<string> names;
+            for (ValNScope& slot : staticData)
+            {
+                if (slot.type == "VAR")
+                {
+                    names.emplace_back(slot.val + "@" + slot.scope);
+                }
+                else
+                {
+                    names.emplace_back("temp " + slot.type);
+                }
+            }
+            return names;
+        }
+
+        // Data type of each static slot (int, string, or boolean for variables, and "" for temporary values)
+        vector<string> getStaticTypes()
+        {
+            vector<string> types;
+            for (ValNScope& slot : staticData)
+            {
+                types.emplace_back(slot.dataType);
+            }
+            return types;
+        }
+
+        // Getters for the pooled strings (S0, S1, etc) and the heap address each one points to
+        vector<string> getStrings()
+        {
+            return this->pooledStrings;
+        }
+
+        vector<int> getStringAddresses()
+        {
+            return this->stringPointers;
+        }
+
     private:
-        // RUNTIME ENVIRONMENT (indices range from 0 - 255)
-        array<string, 0x100> runEnv;
+        // RUNTIME ENVIRONMENT (indices range from 0 to the memory size of the target)
+        vector<string> runEnv;
 
         // Default members
         int programNumber;
         Tree* myAST;
         SymbolTable* mySymTable;
+        Options options;
+        Target target;
 
         HashNode* currentHash;
 
@@ -86,13 +240,15 @@ class CodeGen
             string val;
             string scope;
             string type;
+            string dataType;
 
-            // Constructor for struct
-            ValNScope(const string v, const string s, const string t)
+            // Constructor for struct (data type is only known for variables)
+            ValNScope(const string v, const string s, const string t, const string d = "")
             {
                 val = v;
                 scope = s;
                 type = t;
+                dataType = d;
             }
         };
 
@@ -103,20 +259,146 @@ class CodeGen
         // Keeps track of static data
         int lastStaticIndex = 0;
 
+        // Temporary values whose expression was already used, so they can be given out again (lowest index first)
+        set<int> freeTemps;
+
+        // Instructions generated from the AST (placed in the runtime environment once the whole program is generated)
+        vector<Instruction> code;
+
+        // Node that instructions are currently being generated for
+        Node* currentNode = nullptr;
+
+        // Number of labels created so far (L0, L1, etc)
+        int labelCount = 0;
+
+        // What the registers hold at the current position, and at each label that was branched to but not placed yet
+        RegisterState registers;
+        unordered_map<int, RegisterState> labelRegisters;
+
+        // Whether or not the current position can be reached from the instruction before it
+        bool reachable = true;
+
         // Pointer for inserting code in runtime environment
         int pc = 0x00;
 
         // Pointer for inserting hex in heap
-        int heapVal = 0xff;
+        int heapVal;
 
-        // Stores if there was an error
+        // Stores if there was an error (and what it was)
         bool error = false;
+        string errorMessage;
+
+        // Whether or not the error was running out of memory, or a branch trampolines couldn't bring in range (a smaller program could still work)
+        bool overflow = false;
+        bool tooFar = false;
+
+        // Most bytes a branch can reach while leaving room for a trampoline (6502 offsets are signed, -128 to 127)
+        static const int BRANCH_REACH = 96;
+
+        // Size of an unconditional branch (LDX, CPX, BNE)
+        static const int HOP_SIZE = 7;
+
+        // Most times the program is regenerated to fit branches
+        static const int MAX_ATTEMPTS = 16;
+
+        // Branch chain that leads out of (forward) or back to the top of (backward) a far If/While block
+        // Label is where the chain currently lands (forward) or starts from (backward), anchor is its position
+        struct BranchChain
+        {
+            Node* owner;
+            bool forward;
+            int anchor;
+            int label;
+
+            // Constructor for struct
+            BranchChain(Node* o, const bool f, const int a, const int l)
+            {
+                owner = o;
+                forward = f;
+                anchor = a;
+                label = l;
+            }
+        };
+
+        // Whether or not the IR path gave up on a branch (the rest of the attempts generate from the AST)
+        bool irFailed = false;
+
+        // If/While blocks that need trampolines, and the chains currently being built for them
+        set<Node*> farBranches;
+        vector<BranchChain> activeChains;
+        bool branchOutOfRange = false;
+
+        // Size of each statement and sub-expression from the previous attempt (used to place trampolines ahead of time)
+        unordered_map<Node*, int> statementSizes;
 
-        // Hash map that contains current strings in the heap and its location
-        unordered_map<string, int> existingStrings;
+        // Strings in the order they were first used, placed in the heap once the whole program is generated (S0, S1, etc)
+        vector<string> pooledStrings;
 
-        // Traverses AST and generates hexadecimal code in runtime environment
+        // Address of each pooled string once it is placed
+        vector<int> stringPointers;
+
+        // Traverses AST and generates instructions for each Node
         void traverse(Node* node)
+        {
+            // Instructions are linked to the Node they were generated for
+            Node* parentNode = currentNode;
+            currentNode = node;
+            generateNode(node);
+            currentNode = parentNode;
+        }
+
+        // Lowers the AST to IR, then selects the instructions for it
+        // Variables and temps from the IR become static slots (variables first), and its strings become the pooled strings
+        void selectFromIR()
+        {
+            auto start = chrono::steady_clock::now();
+            IRBuilder builder = IRBuilder(myAST, mySymTable);
+            IRProgram program = builder.lower();
+            auto lowered = chrono::steady_clock::now();
+
+            // Flow-sensitive warnings, then the passes that need to know what reaches and what is live
+            DataFlow dataFlow = DataFlow(program);
+            dataFlow.warnUninitialized();
+            int propagated = 0;
+            int removed = 0;
+            if (options.isEnabled("propagate"))
+            {
+                propagated = dataFlow.propagateConstants();
+            }
+            if (options.isEnabled("dce"))
+            {
+                removed = dataFlow.removeDeadStores();
+            }
+            auto analyzed = chrono::steady_clock::now();
+
+            IRSelector selector = IRSelector(program, options);
+            code = selector.select();
+            auto selected = chrono::steady_clock::now();
+
+            if (options.shouldDumpIR())
+            {
+                program.print(programNumber);
+                dataFlow.print(programNumber);
+            }
+            log("DEBUG", "IR: Lowered to " + to_string(program.size()) + " instruction(s) in " + to_string(program.getBlocks().size()) + " block(s) in " + to_string(chrono::duration_cast<chrono::microseconds>(lowered - start).count()) + " us");
+            log("DEBUG", "IR: Propagated " + to_string(propagated) + " constant(s) and removed " + to_string(removed) + " dead store(s) in " + to_string(chrono::duration_cast<chrono::microseconds>(analyzed - lowered).count()) + " us");
+            log("DEBUG", "IR: Selected " + to_string(code.size()) + " instruction(s) for " + options.getCostModel() + " in " + to_string(chrono::duration_cast<chrono::microseconds>(selected - analyzed).count()) + " us");
+
+            for (IRSymbol& symbol : program.getSymbols())
+            {
+                staticData.emplace_back(symbol.name, symbol.scope, "VAR", symbol.type);
+            }
+            for (const string& kind : selector.getTempKinds())
+            {
+                staticData.emplace_back("0", "0", kind);
+            }
+            lastStaticIndex = staticData.size() - 1;
+            pooledStrings = program.getStrings();
+            pc = getCodeSize();
+        }
+
+        // Generates the instructions for a single Node (and its children)
+        void generateNode(Node* node)
         {
             // If an error was ever detected, escape code generation
             if (error)
@@ -147,7 +429,7 @@ class CodeGen
                 // Traverse through the current AST branch's children
                 for(Node* curNode : node->getChildren())
                 {
-                    traverse(curNode);
+                    traverseMeasured(curNode);
                 }
 
                 // Note that current Symbol Table was traversed
@@ -163,20 +445,17 @@ class CodeGen
                 string newType = node->getChild(0)->getName();
                 string newVar = node->getChild(1)->getName();
                 string newScope = currentHash->getName();
-                staticData.emplace_back(newVar, newScope, "VAR");
+                staticData.emplace_back(newVar, newScope, "VAR", newType);
                 lastStaticIndex = staticData.size() - 1;
 
                 // If the data type is either an int or a boolean, add code that initializes it to 0 (which is false)
                 if (newType != "string")
                 {
                     // Load the accumulator with 0
-                    write("A9");
-                    write("00");
+                    emit("A9", "00");
 
-                    // Store the accumulator in temporary memory location (little endian, will always begin with 00 since highest memory location is 0x00ff, which is 0xff)
-                    write("8D");
-                    write("T" + to_string(lastStaticIndex)); 
-                    write("00");
+                    // Store the accumulator in temporary memory location (little endian, high byte is filled in when backpatching)
+                    emit("8D", "T" + to_string(lastStaticIndex));
                 }
             }
             // Assignment Statement
@@ -189,6 +468,12 @@ class CodeGen
                 // Get the temporary location for the variable (T0, T1, etc)
                 string locationTemp = findVarIndex(locationValue->getName());
 
+                // Adding a constant to the variable itself can be done in memory
+                if (options.isEnabled("strength") && writeIncrement(locationTemp, locationValue, readValue))
+                {
+                    return;
+                }
+
                 // Assigning statement is normal if second child is a leaf node
                 if (readValue->isLeaf())
                 {
@@ -200,18 +485,20 @@ class CodeGen
                 {
                     if (readValue->getName() == "ADD")
                     {
-                        // Add a temporary value to the end of the Stack that holds the sum 
-                        staticData.emplace_back("0", "0", name);
-                        lastStaticIndex = staticData.size() - 1;
-                        currentTempAddress = "T" + to_string(lastStaticIndex);
+                        // Get a temporary value that holds the sum 
+                        currentTempAddress = allocateTemp(name);
                     }
                     traverse(readValue);
+
+                    // The sum is in the accumulator now
+                    if (readValue->getName() == "ADD")
+                    {
+                        releaseTemp(currentTempAddress);
+                    }
                 }
 
                 // Write calculated value (ID or literal) from accumulator into memory at locationTemp
-                write("8D");
-                write(locationTemp);
-                write("00");
+                emit("8D", locationTemp);
             }
             // Print Statement
             else if (name == "Print")
@@ -220,6 +507,13 @@ class CodeGen
                 Node* printValue = node->getChild(0);
                 string type = getType(printValue);
 
+                // Strings outside of the zero page can't be pointed to by the Y register
+                if (type == "string" && target.isPaged())
+                {
+                    writePagedStringPrint(printValue);
+                    return;
+                }
+
                 // Print Statement is normal if child is just a leaf node
                 if (printValue->isLeaf())
                 {
@@ -229,128 +523,178 @@ class CodeGen
                 // If there are more branches, like addition or boolean expressions
                 else 
                 {
+                    string resultTemp = "";
                     if (printValue->getName() == "ADD")
                     {
-                        // Add a temporary value to the end of the Stack that holds the sum 
-                        staticData.emplace_back("0", "0", name);
-                        lastStaticIndex = staticData.size() - 1;
-                        currentTempAddress = "T" + to_string(lastStaticIndex);
+                        // Get a temporary value that holds the sum 
+                        currentTempAddress = allocateTemp(name);
+                        resultTemp = currentTempAddress;
                     }
                     traverse(printValue);
 
-                    // Write traversed value into Y register using temporary address 0xFF
-                    write("8D");
-                    write("FF");
-                    write("00");
+                    // Write to Y register straight from a temporary value when registers are tracked or scratch cells are reserved (a sum is already in one)
+                    if (options.isEnabled("registers") || options.isEnabled("scratch"))
+                    {
+                        if (resultTemp == "")
+                        {
+                            resultTemp = allocateTemp(name);
+                            emit("8D", resultTemp);
+                        }
+                        emit("AC", resultTemp);
+                    }
+                    else
+                    {
+                        // Write traversed value into Y register using temporary address 0xFF (the scratch cell)
+                        emit("8D", scratch());
+
+                        // Write to Y register
+                        emit("AC", scratch());
 
-                    // Write to Y register
-                    write("AC");
-                    write("FF");
-                    write("00");
+                        // Restore 0x00 at 0xFF
+                        emit("A9", "00");
+                        emit("8D", scratch());
+                    }
 
-                    // Restore 0x00 at 0xFF
-                    write("A9");
-                    write("00");
-                    write("8D");
-                    write("FF");
-                    write("00");
+                    // The value is in the Y register now
+                    if (resultTemp != "")
+                    {
+                        releaseTemp(resultTemp);
+                    }
                 }
 
                 // Loads either a 1 or 2 into X register depending on static allocation
-                write("A2");
-
                 // Loads a 1 in the X register if it is not a string
                 if (type != "string")
                 {
-                    write("01");
+                    emit("A2", "01");
                 }
                 // Loads a 2 in the X register if it is a string
                 else
                 {
-                    write("02");
+                    emit("A2", "02");
                 }
 
                 // System call
-                write("FF");
+                emit("FF");
             }
             // IF or WHILE branch
             else if (name == "If" || name == "While")
             {
+                // Loops that run while two values differ can test at the bottom, since BNE branches back when they do
+                if (name == "While" && options.isEnabled("rotate") && node->getChild(0)->getName() == "isNotEq")
+                {
+                    writeRotatedLoop(node);
+                    return;
+                }
+
                 int posBeforeComp = this->pc;
 
-                // If the child of this statement is a leaf
-                if (node->getChild(0)->isLeaf())
+                // Label the top of the loop (nothing is known about the registers here since it gets jumped to)
+                int topLabel = newLabel();
+                if (name == "While")
                 {
-                    // Set the true/false value to the accumulator
-                    write("A9");
-                    addStaticLiteral(node->getChild(0)->getName());
+                    emitLoopLabel(topLabel);
                 }
-                // If it is not a child
-                else 
+
+                // Far blocks branch through trampolines placed between the statements (and expressions) of the block
+                // A loop needs its chain back to the top before the condition, since the condition is inside the loop
+                bool far = farBranches.count(node) > 0;
+                if (far && name == "While")
                 {
-                    // Process boolean expression (isEq or isNotEq)
-                    traverse(node->getChild(0));
+                    activeChains.emplace_back(node, false, posBeforeComp, topLabel);
+                }
+
+                // Branch over block if the condition is false (the label gets placed after the block)
+                int endLabel = newLabel();
+                bool exits = true;
+
+                // Branch straight on the comparison
+                if (options.isEnabled("branches"))
+                {
+                    exits = writeConditionBranch(node->getChild(0), endLabel, node);
+                }
+                else
+                {
+                    // If the child of this statement is a leaf
+                    if (node->getChild(0)->isLeaf())
+                    {
+                        // Set the true/false value to the accumulator
+                        emit("A9", staticLiteral(node->getChild(0)->getName()));
+                    }
+                    // If it is not a child
+                    else 
+                    {
+                        // Process boolean expression (isEq or isNotEq)
+                        traverseMeasured(node->getChild(0));
+                    }
+                    
+                    // Compare accumulator value to 1
+                    // Write accumulator to 0xFF temporarily (or a reserved cell that doesn't need to be reset)
+                    bool reserved = options.isEnabled("scratch");
+                    string cell = scratch();
+                    if (reserved)
+                    {
+                        cell = allocateTemp(name);
+                    }
+                    emit("8D", cell);
+
+                    // Load 1 to X reg
+                    emit("A2", "01");
+
+                    // Compare values
+                    emit("EC", cell);
+
+                    // Reset 0xFF to 0
+                    if (!reserved)
+                    {
+                        emit("A9", "00");
+                        emit("8D", scratch());
+                    }
+                    else
+                    {
+                        releaseTemp(cell);
+                    }
+
+                    // Branch over block if not equal
+                    emitBranch(endLabel, node);
                 }
-                
-                // Compare accumulator value to 1
-                // Write accumulator to 0xFF temporarily
-                write("8D");
-                write("FF");
-                write("00");
-
-                // Load 1 to X reg
-                write("A2");
-                write("01");
-
-                // Compare values
-                write("EC");
-                write("FF");
-                write("00");
-
-                // Reset 0xFF to 0
-                write("A9");
-                write("00");
-                write("8D");
-                write("FF");
-                write("00");
-
-                // Branch n bytes over block if not equal (JP is placeholder for jump)
-                write("D0");
-                write("JP");
 
                 // Get starting position
                 int startPos = this->pc; 
 
+                // Chain out of the block starts at the branch over it
+                if (far && exits)
+                {
+                    activeChains.emplace_back(node, true, startPos, endLabel);
+                }
+
                 // Traverse the Block branch
                 traverse(node->getChild(1));
 
+                // Jump out of the block through the last trampoline if there is one
+                if (far && exits)
+                {
+                    endLabel = activeChains.back().label;
+                    activeChains.pop_back();
+                }
+
                 // If it was a While Statement, need to loop back to the beginning
                 if (name == "While")
                 {
-                    // Do unconditional branch be comparing 1 to 0
-                    write("A2");
-                    write("01");
-
-                    write("EC");
-                    write("FF");
-                    write("00");
-
-                    // Branch
-                    write("D0");
+                    // Loop back through the last trampoline if there is one
+                    int loopLabel = topLabel;
+                    if (far)
+                    {
+                        loopLabel = activeChains.back().label;
+                        activeChains.pop_back();
+                    }
 
-                    // Calculate branch amount
-                    int branchAmt = 255 + posBeforeComp - this->pc; 
-                    write(toHex(branchAmt));
+                    // Do unconditional branch be comparing 1 to 0
+                    emitAlwaysBranch(loopLabel, node);
                 }
 
-                // Get ending position
-                int endingPos = this->pc;
-
-                // Find how long the block was
-                int jumpAmount = endingPos - startPos;
-
-                // Update jump placeholder
-                write(toHex(jumpAmount), startPos - 1);
+                // Land after the block
+                emitLabel(endLabel);
             }
             // ADD branch
             else if (name == "ADD")
@@ -362,180 +706,523 @@ class CodeGen
                 // If second value is another branch, traverse it first
                 if (!secondValue->isLeaf())
                 {
-                    traverse(secondValue);
+                    traverseMeasured(secondValue);
+                }
+                // A variable can be added straight from memory
+                else if (options.isEnabled("strength") && isVariable(secondValue))
+                {
+                    writeToRegister(firstValue, "ACC");
+                    emit("6D", findVarIndex(secondValue->getName()));
+                    emit("8D", currentTempAddress);
+                    return;
                 }
                 // If second value is a digit or ID
                 else
                 {
                     // Write value to temp memory location
                     writeToRegister(secondValue, "ACC");
-                    write("8D");
-                    write(currentTempAddress);
-                    write("00");
+                    emit("8D", currentTempAddress);
                 }
 
                 // Write first value to accumulator
                 writeToRegister(firstValue, "ACC");
                 
                 // Perform add with temporary location
-                write("6D");
-                write(currentTempAddress);
-                write("00");
+                emit("6D", currentTempAddress);
 
                 // Move value to temporary location
-                write("8D");
-                write(currentTempAddress);
-                write("00");
+                emit("8D", currentTempAddress);
             }
             // isEq branch
             else if (name == "isEq" || name == "isNotEq")
             {
-                // Adds temporary value to the end of the Stack that holds boolean values (0 or 1)
-                staticData.emplace_back("0", "0", name);
-                lastStaticIndex = staticData.size() - 1;
-                string tempAddress = "T" + to_string(lastStaticIndex);
-
-                // Get information about two values being compared
-                Node* firstValue = node->getChild(0);
-                Node* secondValue = node->getChild(1);
-
-                // If first value is another branch, traverse it first
-                if (!firstValue->isLeaf())
-                {
-                    if (firstValue->getName() == "ADD")
-                    {
-                        // Add a temporary value to the end of the Stack that holds the sum 
-                        staticData.emplace_back("0", "0", name);
-                        lastStaticIndex = staticData.size() - 1;
-                        currentTempAddress = "T" + to_string(lastStaticIndex);
-                    }
-                    traverse(firstValue);
-                }
-                // If first value is an actual value, write to accumulator
-                else
-                {
-                    writeToRegister(firstValue, "ACC");
-                }
-
-                // Write result of first value to temporary location
-                write("8D");
-                write(tempAddress);
-                write("00");
-
-                // If second value is another branch, traverse it first
-                if (!secondValue->isLeaf())
-                {
-                    if (secondValue->getName() == "ADD")
-                    {
-                        // Add a temporary value to the end of the Stack that holds the sum 
-                        staticData.emplace_back("0", "0", name);
-                        lastStaticIndex = staticData.size() - 1;
-                        currentTempAddress = "T" + to_string(lastStaticIndex);
-                    }
-                    traverse(secondValue);
-                }
-                // If second value is an actual value
-                else
-                {
-                    // Write value into accumulator
-                    writeToRegister(secondValue, "ACC");
-                }
-
-                // Write the first value into X register
-                write("AE");
-                write(tempAddress);
-                write("00");
-
-                // Write second value into temporary address
-                write("8D");
-                write(tempAddress);
-                write("00");
-
-                // Compare value in temporary address to X register
-                write("EC");
-                write(tempAddress);
-                write("00");
+                // Compare the two values (Z flag is set if they are equal)
+                writeComparison(node);
 
                 // Write a 0 into the accumulator if op was isEq
-                write("A9");
                 if (name == "isEq")
                 {
-                    write("00");   
+                    emit("A9", "00");
                 }
                 // Write a 1 into the accumulator if op was isNotEq
                 else 
                 {
-                    write("01");
+                    emit("A9", "01");
                 }
 
-                // Branch 2 bytes if unequal
-                write("D0");
-                write("02");
+                // Branch over the next load if unequal
+                int unequalLabel = newLabel();
+                emitBranch(unequalLabel, node);
 
                 // If boolean expression was equal, set accumulator to 1 if op was isEq
-                write("A9");
                 if (name == "isEq")
                 {
-                    write("01");
+                    emit("A9", "01");
                 }
                 else
                 {
-                    write("00");
+                    emit("A9", "00");
                 }
+                emitLabel(unequalLabel);
             }
         }
 
-        // Backpatches after code was generated
-        void backpatch()
+        // Traverses a statement or sub-expression where only the accumulator could be live
+        // Trampolines don't touch the accumulator, so they can be placed on either side of it
+        void traverseMeasured(Node* node)
         {
-            // Get real values into a vector
-            vector<string> newValues;
-            for (int i = 0, n = staticData.size(); i < n; i++)
+            // Make room for trampolines before it would carry a branch out of range
+            placeTrampolines(node);
+
+            int start = this->pc;
+            traverse(node);
+            statementSizes[node] = this->pc - start;
+
+            // Code after it runs until the next trampoline can be placed
+            placeTrampolines(nullptr);
+        }
+
+        // Writes an assignment like a = 2 + a by incrementing the variable, if that costs less than adding (returns whether or not it did)
+        bool writeIncrement(const string locationTemp, Node* locationValue, Node* readValue)
+        {
+            if (readValue->getName() != "ADD")
             {
-                string curType = staticData[i].type;
-                if (curType == "VAR")
-                {
-                    log("DEBUG", "Backpatch: Variable '" + staticData[i].val + "' [T" + to_string(i) + "] with [" + toHex(pc) + "]");
-                }
-                else if (curType == "ADD")
-                {
-                    log("DEBUG", "Backpatch: Addition at [T" + to_string(i) + "] with [" + toHex(pc) + "]");
-                }
-                else if (curType == "If" || curType == "While" || curType == "isEq" || curType == "isNotEq")
-                {
-                    log("DEBUG", "Backpatch: Boolean at [T" + to_string(i) + "] with [" + toHex(pc) + "]");
-                }
-                newValues.emplace_back(to_string(pc));
-                pc++;
+                return false;
             }
 
-            // Store index for runtime environment
-            int index = 0;
+            // One side is the variable being assigned and the other is a constant
+            Node* constant = readValue->getChild(0);
+            Node* variable = readValue->getChild(1);
+            if (isVariable(constant))
+            {
+                swap(constant, variable);
+            }
+            if (!isVariable(variable) || variable->getName() != locationValue->getName() || constant->getToken()->getType() != "DIGIT")
+            {
+                return false;
+            }
+            int amount = stoi(constant->getName()) % 0x100;
 
-            // Replace temporary values in runtime environment with real values
-            for (string s : runEnv)
+            // Compare incrementing that many times with adding the constant from the accumulator
+            vector<string> increments(amount, "EE");
+            if (cost(increments) > cost({"A9", "6D", "8D"}))
             {
-                // Checks if its a temporary value
-                if (s[0] == 'T')
-                {
-                    // Get real value (converts X in TX to an integer)
-                    char val = s[1];
-                    int correctIndex = val - '0';
+                return false;
+            }
 
-                    // Replace temp value with real value
-                    write(toHex(stoi(newValues[correctIndex])), index);
-                }
-                index++;
+            log("DEBUG", "Strength Reduction: Incrementing [" + locationValue->getName() + "] " + to_string(amount) + " time(s) instead of adding");
+            for (int i = 0; i < amount; i++)
+            {
+                emit("EE", locationTemp);
             }
+            return true;
         }
 
-        // Write into the runtime environment at location of pc pointer (or specified index)
-        void write(const string hex, int index = -1)
+        // Cost of a sequence of op codes from the target's cost table (bytes with -Os, cycles otherwise)
+        int cost(const vector<string> opCodes)
         {
-            // Check if there wasn't any overflow error
-            if (index >= -1 && index < 0xff && pc < heapVal)
+            int total = 0;
+            for (const string& opCode : opCodes)
             {
-                // If not writing into specified index, write it at program counter
+                if (options.getLevel() == "s")
+                {
+                    total += OP_CODES.at(opCode).size;
+                }
+                else
+                {
+                    total += OP_CODES.at(opCode).cycles;
+                }
+            }
+            return total;
+        }
+
+        // Writes a While loop that is entered at its test, which comes after the block and branches back to the top
+        // Each time through the loop only takes the one branch back, instead of the test's branch and an unconditional one
+        void writeRotatedLoop(Node* node)
+        {
+            Node* condition = node->getChild(0);
+            bool far = farBranches.count(node) > 0;
+
+            // Jump to the test the first time
+            int testLabel = newLabel();
+            emitAlwaysBranch(testLabel, node);
+
+            // Label the top of the block (nothing is known about the registers here since it gets jumped to)
+            int topLabel = newLabel();
+            emitLoopLabel(topLabel);
+
+            // Far blocks get a chain back to the top and a chain from the jump to the test
+            if (far)
+            {
+                activeChains.emplace_back(node, false, this->pc, topLabel);
+                activeChains.emplace_back(node, true, this->pc, testLabel);
+            }
+
+            // Traverse the Block branch
+            traverse(node->getChild(1));
+
+            // The jump to the test lands through the last trampoline if there is one
+            if (far)
+            {
+                testLabel = activeChains.back().label;
+                activeChains.pop_back();
+            }
+            emitLabel(testLabel);
+
+            // Trampolines can go before the comparison, but not between it and the branch
+            placeTrampolines(condition);
+            int start = this->pc;
+
+            // Compare the values (instructions belong to the comparison)
+            Node* parentNode = currentNode;
+            currentNode = condition;
+            writeComparison(condition);
+
+            // Loop back through the last trampoline if there is one
+            int loopLabel = topLabel;
+            if (far)
+            {
+                loopLabel = activeChains.back().label;
+                activeChains.pop_back();
+            }
+
+            // Values are still different, so go around again
+            emitBranch(loopLabel, node);
+            currentNode = parentNode;
+
+            statementSizes[condition] = this->pc - start;
+        }
+
+        // Branches to the end label when an If/While condition is false, without putting the boolean in the accumulator
+        // Returns false if the condition is always true, since nothing branches then
+        bool writeConditionBranch(Node* condition, const int endLabel, Node* owner)
+        {
+            string name = condition->getName();
+
+            // Literals are known, so the block always runs (true) or never does (false)
+            if (condition->isLeaf())
+            {
+                if (name == "true")
+                {
+                    return false;
+                }
+                emitAlwaysBranch(endLabel, owner);
+                return true;
+            }
+
+            // Trampolines can go before the comparison, but not between it and the branch
+            placeTrampolines(condition);
+            int start = this->pc;
+
+            // Compare the values (instructions belong to the comparison)
+            Node* parentNode = currentNode;
+            currentNode = condition;
+            writeComparison(condition);
+
+            // Not equal means an isEq is false
+            if (name == "isEq")
+            {
+                emitBranch(endLabel, owner);
+            }
+            // Not equal means an isNotEq is true, so branch into the block and otherwise jump over it
+            else
+            {
+                int blockLabel = newLabel();
+                emitBranch(blockLabel, owner);
+                emitAlwaysBranch(endLabel, owner);
+                emitLabel(blockLabel);
+            }
+            currentNode = parentNode;
+
+            statementSizes[condition] = this->pc - start;
+            return true;
+        }
+
+        // Compares the two values of an isEq or isNotEq, setting the Z flag if they are equal
+        void writeComparison(Node* node)
+        {
+            string name = node->getName();
+            Node* firstValue = node->getChild(0);
+            Node* secondValue = node->getChild(1);
+
+            // When registers are tracked, a variable is compared straight from memory with the other value in the X register
+            if (options.isEnabled("registers") && (isVariable(firstValue) || isVariable(secondValue)))
+            {
+                Node* memoryValue = secondValue;
+                Node* registerValue = firstValue;
+                if (!isVariable(secondValue))
+                {
+                    memoryValue = firstValue;
+                    registerValue = secondValue;
+                }
+
+                if (registerValue->isLeaf())
+                {
+                    writeToRegister(registerValue, "X");
+                }
+                // Expressions end up in the accumulator (and a sum in its temporary value), so move it through a temporary value
+                else
+                {
+                    string resultTemp = allocateTemp(name);
+                    if (registerValue->getName() == "ADD")
+                    {
+                        currentTempAddress = resultTemp;
+                    }
+                    traverseMeasured(registerValue);
+                    if (registerValue->getName() != "ADD")
+                    {
+                        emit("8D", resultTemp);
+                    }
+                    emit("AE", resultTemp);
+                    releaseTemp(resultTemp);
+                }
+
+                emit("EC", findVarIndex(memoryValue->getName()));
+                return;
+            }
+
+            // Get a temporary value that holds the first value while the second one is found
+            string tempAddress = allocateTemp(name);
+
+            // If first value is another branch, traverse it first
+            if (!firstValue->isLeaf())
+            {
+                if (firstValue->getName() == "ADD")
+                {
+                    // Get a temporary value that holds the sum 
+                    currentTempAddress = allocateTemp(name);
+                }
+                traverseMeasured(firstValue);
+
+                // The sum is in the accumulator now
+                if (firstValue->getName() == "ADD")
+                {
+                    releaseTemp(currentTempAddress);
+                }
+            }
+            // If first value is an actual value, write to accumulator
+            else
+            {
+                writeToRegister(firstValue, "ACC");
+            }
+
+            // Write result of first value to temporary location
+            emit("8D", tempAddress);
+
+            // If second value is another branch, traverse it first
+            if (!secondValue->isLeaf())
+            {
+                if (secondValue->getName() == "ADD")
+                {
+                    // Get a temporary value that holds the sum 
+                    currentTempAddress = allocateTemp(name);
+                }
+                traverseMeasured(secondValue);
+
+                // The sum is in the accumulator now
+                if (secondValue->getName() == "ADD")
+                {
+                    releaseTemp(currentTempAddress);
+                }
+            }
+            // If second value is an actual value
+            else
+            {
+                // Write value into accumulator
+                writeToRegister(secondValue, "ACC");
+            }
+
+            // Write the first value into X register
+            emit("AE", tempAddress);
+
+            // Write second value into temporary address
+            emit("8D", tempAddress);
+
+            // Compare value in temporary address to X register
+            emit("EC", tempAddress);
+
+            // The first value isn't needed anymore
+            releaseTemp(tempAddress);
+        }
+
+        // Gets a temporary value in static data for an expression (type is the statement or expression that needs it)
+        // When temps are reused, a temporary value that is no longer needed is given out before adding a new one
+        string allocateTemp(const string type)
+        {
+            if (options.isEnabled("temps") && !freeTemps.empty())
+            {
+                int index = *freeTemps.begin();
+                freeTemps.erase(freeTemps.begin());
+                return "T" + to_string(index);
+            }
+
+            // Add a temporary value to the end of the Stack
+            staticData.emplace_back("0", "0", type);
+            lastStaticIndex = staticData.size() - 1;
+            return "T" + to_string(lastStaticIndex);
+        }
+
+        // Marks a temporary value as no longer needed once its expression was used
+        void releaseTemp(const string temp)
+        {
+            if (options.isEnabled("temps"))
+            {
+                freeTemps.insert(stoi(temp.substr(1)));
+            }
+        }
+
+        // Backpatches after code was generated
+        void backpatch()
+        {
+            // Get real values into a vector
+            vector<int> newValues;
+            for (int i = 0, n = staticData.size(); i < n; i++)
+            {
+                string curType = staticData[i].type;
+                if (curType == "VAR")
+                {
+                    log("DEBUG", "Backpatch: Variable '" + staticData[i].val + "' [T" + to_string(i) + "] with [" + toHex(pc) + "]");
+                }
+                else if (curType == "ADD")
+                {
+                    log("DEBUG", "Backpatch: Addition at [T" + to_string(i) + "] with [" + toHex(pc) + "]");
+                }
+                else if (curType == "If" || curType == "While" || curType == "isEq" || curType == "isNotEq")
+                {
+                    log("DEBUG", "Backpatch: Boolean at [T" + to_string(i) + "] with [" + toHex(pc) + "]");
+                }
+                newValues.emplace_back(pc);
+                pc++;
+            }
+
+            // Static data can't run into the heap
+            if (pc > heapVal)
+            {
+                error = true;
+                errorMessage = memoryOverflowMessage();
+                overflow = true;
+                return;
+            }
+
+            // Replace temporary values in runtime environment with real values
+            for (int index = 0, n = runEnv.size(); index < n; index++)
+            {
+                // Checks if its a temporary value
+                string s = runEnv[index];
+                if (s[0] == 'T')
+                {
+                    // Get real value (converts X in TX to an integer)
+                    int correctIndex = stoi(s.substr(1));
+
+                    // Replace temp value with real value (little endian)
+                    write(toHex(newValues[correctIndex] & 0xFF), index);
+                    write(toHex(newValues[correctIndex] >> 8), index + 1);
+                }
+            }
+        }
+
+        // Places the instructions in the runtime environment, resolving labels to branch offsets and code addresses
+        void assemble()
+        {
+            // Find where every label ends up
+            unordered_map<string, int> labels;
+            int address = 0;
+            for (Instruction& instruction : code)
+            {
+                if (instruction.isLabel())
+                {
+                    labels[instruction.getOperand()] = address;
+                }
+                instruction.setAddress(address);
+                address += instruction.getSize();
+            }
+
+            pc = 0x00;
+            for (Instruction& instruction : code)
+            {
+                string mode = instruction.getMode();
+                string operand = instruction.getOperand();
+                if (mode == "label")
+                {
+                    continue;
+                }
+
+                write(instruction.getOpCode());
+
+                if (mode == "immediate")
+                {
+                    write(operand);
+                }
+                else if (mode == "relative")
+                {
+                    write(branchOffset(this->pc + 1, labels[operand], instruction.getNode()));
+                }
+                else if (mode == "absolute")
+                {
+                    // Temporary addresses get backpatched
+                    if (operand[0] == 'T')
+                    {
+                        writeAddress(operand);
+                    }
+                    // Code addresses are a label plus an offset (L0+1)
+                    else if (operand[0] == 'L')
+                    {
+                        size_t plus = operand.find('+');
+                        writeAddress(labels[operand.substr(0, plus)] + stoi(operand.substr(plus + 1)));
+                    }
+                    // Otherwise it's a real address in hex
+                    else
+                    {
+                        writeAddress(stoi(operand, nullptr, 16));
+                    }
+                }
+            }
+        }
+
+        // Resets code generation so the program can be generated again
+        void reset()
+        {
+            fill(runEnv.begin(), runEnv.end(), "00");
+            code.clear();
+            labelCount = 0;
+            staticData.clear();
+            pooledStrings.clear();
+            stringPointers.clear();
+            activeChains.clear();
+            currentTempAddress = "";
+            lastStaticIndex = 0;
+            freeTemps.clear();
+            registers.clear();
+            labelRegisters.clear();
+            reachable = true;
+            pc = 0x00;
+            heapVal = target.getScratchAddress();
+            error = false;
+            overflow = false;
+            tooFar = false;
+
+            // Scopes get marked as traversed during code generation
+            currentHash = mySymTable->getRoot();
+            resetTraversed(currentHash);
+        }
+
+        // Marks every scope in the Symbol Table as not traversed
+        void resetTraversed(HashNode* node)
+        {
+            node->resetTraversed();
+            for (HashNode* child : node->getChildren())
+            {
+                resetTraversed(child);
+            }
+        }
+
+        // Write into the runtime environment at location of pc pointer (or specified index)
+        void write(const string hex, int index = -1)
+        {
+            // Check if there wasn't any overflow error
+            if (index >= -1 && index < target.getScratchAddress() && pc < heapVal)
+            {
+                // If not writing into specified index, write it at program counter
                 if (index == -1)
                 {
                     index = pc;
@@ -551,7 +1238,229 @@ class CodeGen
             else
             {
                 error = true;
+                errorMessage = memoryOverflowMessage();
+                overflow = true;
+            }
+        }
+
+        // Writes a temporary address (high byte is replaced along with it when backpatching)
+        void writeAddress(const string temp)
+        {
+            write(temp);
+            write("00");
+        }
+
+        // Writes a real address (little endian)
+        void writeAddress(const int address)
+        {
+            write(toHex(address & 0xFF));
+            write(toHex(address >> 8));
+        }
+
+        // Adds an instruction for the current Node
+        void emit(const string opCode, const string operand = "")
+        {
+            Instruction instruction = Instruction(opCode, operand, currentNode);
+
+            // Loads into a register that already holds the value are skipped
+            if (options.isEnabled("registers") && registers.holds(instruction))
+            {
+                log("DEBUG", "Registers: Skipping " + instruction.getMnemonic() + " [" + operand + "], the register already holds it");
+                return;
+            }
+            registers.update(instruction);
+
+            code.emplace_back(instruction);
+            pc += code.back().getSize();
+        }
+
+        // Creates a new label (placed later with emitLabel)
+        int newLabel()
+        {
+            return labelCount++;
+        }
+
+        // Places a label at the current position in the code (every branch to it has to come before it)
+        void emitLabel(const int label)
+        {
+            code.emplace_back(Instruction::label(label));
+
+            // Registers only hold what they hold on every path here
+            auto found = labelRegisters.find(label);
+            if (found != labelRegisters.end())
+            {
+                if (reachable)
+                {
+                    registers.merge(found->second);
+                }
+                else
+                {
+                    registers = found->second;
+                }
+            }
+            else if (!reachable)
+            {
+                registers.clear();
+            }
+            reachable = true;
+        }
+
+        // Places a label that gets branched back to later (like the top of a loop), so nothing is known about the registers
+        void emitLoopLabel(const int label)
+        {
+            code.emplace_back(Instruction::label(label));
+            registers.clear();
+            reachable = true;
+        }
+
+        // Branches to a label if not equal (owner is the block that needs trampolines if it is too far)
+        void emitBranch(const int label, Node* owner)
+        {
+            code.emplace_back("D0", "L" + to_string(label), owner);
+            pc += code.back().getSize();
+
+            // The label gets what the registers hold on this path
+            auto found = labelRegisters.find(label);
+            if (found != labelRegisters.end())
+            {
+                found->second.merge(registers);
+            }
+            else
+            {
+                labelRegisters[label] = registers;
+            }
+        }
+
+        // Unconditional branch to a label (compares 1 to the 0x00 in the scratch cell)
+        void emitAlwaysBranch(const int label, Node* owner)
+        {
+            emit("A2", "01");
+            emit("EC", scratch());
+            emitBranch(label, owner);
+
+            // Nothing falls through to the next instruction
+            reachable = false;
+        }
+
+        // Address of the scratch cell in hex (top of memory)
+        string scratch()
+        {
+            return toAddress(target.getScratchAddress());
+        }
+
+        // Converts an address to hex with all 4 digits
+        string toAddress(const int address)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(4) << setfill('0') << address;
+            return result.str();
+        }
+
+        // Gets the offset for a branch whose next instruction is at "from"
+        // Only the zero page wraps around, so anything bigger notes the block that needs trampolines
+        string branchOffset(const int from, const int to, Node* owner)
+        {
+            int offset = to - from;
+            if (target.isPaged() && (offset > 127 || offset < -128))
+            {
+                farBranches.insert(owner);
+                branchOutOfRange = true;
             }
+            return toHex(offset & 0xFF);
+        }
+
+        // Places trampolines for any far branch that wouldn't reach past the upcoming statement (or sub-expression)
+        void placeTrampolines(Node* nextStatement)
+        {
+            if (activeChains.empty())
+            {
+                return;
+            }
+
+            // Size of the statement last time it was generated (0 on the first attempt or if nothing is next)
+            int estimate = 0;
+            if (nextStatement && statementSizes.find(nextStatement) != statementSizes.end())
+            {
+                estimate = statementSizes[nextStatement];
+            }
+
+            // Find the chains that would be out of reach after the statement (assumes every chain needs a hop)
+            int worstCase = HOP_SIZE * (activeChains.size() + 1);
+            vector<int> due;
+            for (int i = 0, n = activeChains.size(); i < n; i++)
+            {
+                if (pc + estimate + worstCase - activeChains[i].anchor > BRANCH_REACH)
+                {
+                    due.emplace_back(i);
+                }
+            }
+
+            if (due.empty())
+            {
+                return;
+            }
+
+            // Code falling through skips over the hops
+            int skipLabel = newLabel();
+            emitAlwaysBranch(skipLabel, activeChains[due[0]].owner);
+
+            // Each hop continues its chain
+            for (int i : due)
+            {
+                BranchChain& chain = activeChains[i];
+                int hopStart = this->pc;
+
+                // Forward chains land here and branch to the next hop
+                if (chain.forward)
+                {
+                    emitLabel(chain.label);
+                    chain.label = newLabel();
+                    emitAlwaysBranch(chain.label, chain.owner);
+                    chain.anchor = this->pc;
+                }
+                // Backward chains jump to the previous hop, and later hops will jump here
+                else
+                {
+                    int hopLabel = newLabel();
+                    emitLoopLabel(hopLabel);
+                    emitAlwaysBranch(chain.label, chain.owner);
+                    chain.label = hopLabel;
+                    chain.anchor = hopStart;
+                }
+            }
+            emitLabel(skipLabel);
+        }
+
+        // Prints a string using the address in the operand of the system call, since the heap isn't in the zero page
+        void writePagedStringPrint(Node* node)
+        {
+            // High byte is always the heap page
+            int heapPage = target.getHeapPage() << 8;
+
+            // Copy the variable's pointer into the operand of the system call
+            if (node->getToken()->getType() == "ID")
+            {
+                int callLabel = newLabel();
+                emit("AD", findVarIndex(node->getName()));
+                emit("8D", "L" + to_string(callLabel) + "+1");
+                emit("A2", "03");
+                emitLabel(callLabel);
+                emit("FF", toAddress(heapPage));
+            }
+            // Literals point straight to the heap
+            else
+            {
+                emit("A2", "03");
+
+                // The string gets its full address once it is placed
+                emit("FF", createString(node->getName()));
+            }
+        }
+
+        // Message for when the generated code doesn't fit in memory
+        string memoryOverflowMessage()
+        {
+            return "Memory Overflow: Generated code exceeds available address space (" + to_string(target.getMemorySize()) + " bytes)";
         }
 
         // Writes a value to a register
@@ -587,9 +1496,7 @@ class CodeGen
             if (node->getToken()->getType() == "ID")
             {
                 // Load the register with the variable (or pointer)
-                write(varCode);
-                write(findVarIndex(node->getName()));
-                write("00");
+                emit(varCode, findVarIndex(node->getName()));
             }
             // If it wasn't an ID, it's a literal
             else
@@ -598,58 +1505,144 @@ class CodeGen
                 string literalName = node->getName();
 
                 // Load register with constant
-                write(constantCode);
-
                 // If it is a string literal, create the string in heap
                 if (type == "string")
                 {
-                    createString(node->getName());
+                    emit(constantCode, createString(node->getName()));
                 }
                 // If it is statically allocated
                 else
                 {
                     // Adds the literal to the runtime environment
-                    addStaticLiteral(literalName);
+                    emit(constantCode, staticLiteral(literalName));
                 }
             }
         }
 
-        // Writes a string into the heap in the runtime environment
-        void createString(const string str)
+        // Adds a string to the pool and returns its pooled operand (S0), which gets its pointer once every string is known
+        string createString(const string str)
         {
-            // If this string doesn't already exists
-            if (existingStrings.find(str) == existingStrings.end())
+            auto found = find(pooledStrings.begin(), pooledStrings.end(), str);
+            if (found == pooledStrings.end())
             {
-                // Update the heap pointer
-                heapVal = heapVal - str.length() - 1;
+                pooledStrings.emplace_back(str);
+                found = pooledStrings.end() - 1;
+            }
+            return "S" + to_string(found - pooledStrings.begin());
+        }
+
+        // Writes the characters of a string below the last one in the heap, returns its address (-1 if it doesn't fit)
+        int placeString(const string str)
+        {
+            // Update the heap pointer
+            heapVal = heapVal - str.length() - 1;
 
-                // Create temporary pointer
-                int ptr = heapVal + 1;
+            // Create temporary pointer
+            int ptr = heapVal + 1;
 
-                // Add to hash map of existing strings
-                existingStrings[str] = ptr;
+            // Pointers are a single byte, so the heap has to stay in its page
+            if (target.isPaged() && ptr < target.getHeapStart())
+            {
+                error = true;
+                errorMessage = "Heap Overflow: Strings exceed the heap page (256 bytes)";
+                overflow = true;
+                return -1;
+            }
 
-                // For each character in the string
-                for (char c : str)
+            // The heap can't go below the start of memory (code is checked once it gets placed)
+            if (ptr < 0)
+            {
+                error = true;
+                errorMessage = memoryOverflowMessage();
+                overflow = true;
+                return -1;
+            }
+
+            // For each character in the string
+            for (char c : str)
+            {
+                // Convert to ASCII
+                int asciiVal = c;
+
+                // Write into heap
+                runEnv[ptr] = toHex(asciiVal);
+
+                ptr++;
+            }
+
+            return heapVal + 1;
+        }
+
+        // Places every pooled string in the heap (from the top down, in the order they were first used) and gives the instructions that use them their pointers
+        // Strings are read up to their 0x00, so with the strings pass a string that is the end of a longer one (like "world" in "hello world") points into it
+        void layoutStrings()
+        {
+            vector<int>& pointers = stringPointers;
+            pointers.assign(pooledStrings.size(), -1);
+
+            // Strings that aren't the end of a longer one get their own bytes, in the order they were first used
+            for (int i = 0, n = pooledStrings.size(); i < n; i++)
+            {
+                if (longestEndingWith(i) == i)
                 {
-                    // Convert to ASCII
-                    int asciiVal = c;
+                    pointers[i] = placeString(pooledStrings[i]);
+                    if (pointers[i] < 0)
+                    {
+                        return;
+                    }
+                }
+            }
 
-                    // Write into heap
-                    write(toHex(asciiVal), ptr);
+            // The rest point to their end of the longest string that ends with them (it always has its own bytes)
+            for (int i = 0, n = pooledStrings.size(); i < n; i++)
+            {
+                int longest = longestEndingWith(i);
+                if (longest != i)
+                {
+                    pointers[i] = pointers[longest] + pooledStrings[longest].length() - pooledStrings[i].length();
+                    log("DEBUG", "Strings: \"" + pooledStrings[i] + "\" shares the end of \"" + pooledStrings[longest] + "\" at [" + toAddress(pointers[i]) + "]");
+                }
+            }
 
-                    ptr++;
+            // Pointers are a single byte, except for the system call operand that prints on paged targets
+            for (Instruction& instruction : code)
+            {
+                string operand = instruction.getOperand();
+                if (!instruction.isLabel() && operand != "" && operand[0] == 'S')
+                {
+                    int pointer = pointers[stoi(operand.substr(1))];
+                    instruction.setSymbol(operand);
+                    if (instruction.getMode() == "absolute")
+                    {
+                        instruction.setOperand(toAddress(pointer));
+                    }
+                    else
+                    {
+                        instruction.setOperand(toHex(pointer & 0xFF));
+                    }
                 }
+            }
+        }
 
-                // Write string pointer into code
-                write(toHex(heapVal + 1));
+        // Index of the longest pooled string that ends with another one (itself if there is none, or if strings can't be shared)
+        int longestEndingWith(const int index)
+        {
+            const string& str = pooledStrings[index];
+            int longest = index;
+            if (!options.isEnabled("strings"))
+            {
+                return longest;
             }
-            // If the string already exists
-            else
+
+            for (int i = 0, n = pooledStrings.size(); i < n; i++)
             {
-                // Write its position in the runtime environment
-                write(toHex(existingStrings[str]));
+                const string& other = pooledStrings[i];
+                if (other.length() > pooledStrings[longest].length() && other.compare(other.length() - str.length(), str.length(), str) == 0)
+                {
+                    longest = i;
+                }
             }
+            return longest;
         }
 
         // Convert decimal to hexadecimal
@@ -695,6 +1688,12 @@ class CodeGen
             return 'T' + to_string(correctIndex);
         }
 
+        // Returns whether or not a Node is a variable
+        bool isVariable(Node* node)
+        {
+            return node->isLeaf() && node->getToken()->getType() == "ID";
+        }
+
         // Gets the type of a variable from the symbol table
         string getType(Node* curNode)
         {
@@ -734,23 +1733,20 @@ class CodeGen
             return type;
         }
 
-        // Converts false/true to 0/1 respectively and writes it (and writes integers)
-        void addStaticLiteral(string name)
+        // Converts false/true to 0/1 respectively (and converts integers to hex)
+        string staticLiteral(string name)
         {
             // Convert false/true to 0/1 respectively
             if (name == "false")
             {
-                write("00");
+                return "00";
             }
             else if (name == "true")
             {
-                write("01");
-            }
-            // Otherwise its a literal integer (0-9, so pad with 0)
-            else 
-            {
-                write("0" + name);
+                return "01";
             }
+            // Otherwise its a literal integer (0-9, or bigger once constants are folded)
+            return toHex(stoi(name));
         }
 
         // Logging function for CodeGen
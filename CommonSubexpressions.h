@@ -0,0 +1,418 @@
+#ifndef COMMONSUBEXPRESSIONS_H
+#define COMMONSUBEXPRESSIONS_H
+
+using namespace std;
+
+// Finds ADD/isEq/isNotEq expressions that compute a value that was already computed (value numbering)
+// Variables are numbered by the assignment that reaches them, so expressions only match if their variables haven't changed
+// The first one is stored in a new variable ($v0, $v1, etc) that the rest read instead, if the cost model says it's cheaper
+class CommonSubexpressions
+{
+    public:
+        // Default constructor for the CommonSubexpressions class
+        CommonSubexpressions(const int progNum, Tree* progAST, SymbolTable* progSymTable)
+        {
+            this->programNumber = progNum;
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+        }
+
+        // Reuses every value that was computed before, returns how many expressions were replaced
+        int eliminate()
+        {
+            values.clear();
+            available.clear();
+            versions.clear();
+            declared.clear();
+
+            numberBlock(myAST->getRoot(), mySymTable->getRoot());
+
+            int replaced = 0;
+            for (Value& value : values)
+            {
+                replaced += reuse(value);
+            }
+
+            log("DEBUG", "Common Subexpressions: Replaced " + to_string(replaced) + " expression(s) in Program #" + to_string(programNumber));
+            return replaced;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Tree* myAST;
+        SymbolTable* mySymTable;
+
+        // Byte costs for the cost model (storing the value once, reading it back, and its byte in static data)
+        static const int STORE_COST = 3;
+        static const int LOAD_COST = 3;
+        static const int STATIC_COST = 1;
+
+        // A variable is its name and the scope it was declared in
+        typedef pair<HashNode*, string> Variable;
+
+        // An expression that was computed, and every later expression that computes the same value
+        struct Value
+        {
+            Node* first;
+            vector<Node*> uses;
+
+            // Constructor for struct
+            Value(Node* f)
+            {
+                first = f;
+            }
+        };
+
+        // Every value in the order they were found, and the values that are available at the current point (by key)
+        vector<Value> values;
+        map<string, int> available;
+
+        // Number of the assignment that reaches each variable
+        map<Variable, int> versions;
+        int versionCount = 0;
+
+        // Variables declared so far (a variable can't be read before its declaration, even if its scope already has it)
+        set<Variable> declared;
+
+        // Symbol Table scope of every Block (new variables are added to the scope of the Block they are declared in)
+        unordered_map<Node*, HashNode*> blockScopes;
+
+        // Tokens for the new Nodes (deque so pointers to them stay valid)
+        deque<Token> newTokens;
+
+        int tempCount = 0;
+
+        // Numbers every expression in a Block (scope is the Symbol Table scope that belongs to the Block)
+        void numberBlock(Node* block, HashNode* scope)
+        {
+            blockScopes[block] = scope;
+
+            // Child scopes are in the same order as the Blocks inside this one
+            int scopeIndex = 0;
+
+            for (Node* statement : block->getChildren())
+            {
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    // A value first computed in the Block is stored in a variable of its scope, which is gone after it
+                    map<string, int> before = available;
+                    numberBlock(statement, scope->getChild(scopeIndex));
+                    available = before;
+                    scopeIndex++;
+                }
+                else if (name == "Declare")
+                {
+                    Variable var = Variable(scope, statement->getChild(1)->getName());
+                    declared.insert(var);
+                    versions[var] = versionCount++;
+                }
+                else if (name == "Assign")
+                {
+                    numberExpression(statement->getChild(1), scope, true);
+                    versions[resolve(statement->getChild(0)->getName(), scope)] = versionCount++;
+                }
+                else if (name == "Print")
+                {
+                    numberExpression(statement->getChild(0), scope, true);
+                }
+                else if (name == "If")
+                {
+                    // The condition has to stay a comparison, so only its values can be reused
+                    for (Node* child : statement->getChild(0)->getChildren())
+                    {
+                        numberExpression(child, scope, true);
+                    }
+
+                    // Values from the block might not have been computed after it, and anything it assigns could have either value
+                    map<string, int> before = available;
+                    numberBlock(statement->getChild(1), scope->getChild(scopeIndex));
+                    available = before;
+                    changeAssigned(statement->getChild(1));
+                    scopeIndex++;
+                }
+                else if (name == "While")
+                {
+                    // The top of the loop is reached again after the block, so anything it assigns could have any value there
+                    changeAssigned(statement->getChild(1));
+
+                    // The condition runs every time through the loop, so values in it can't be stored before the loop
+                    for (Node* child : statement->getChild(0)->getChildren())
+                    {
+                        numberExpression(child, scope, false);
+                    }
+
+                    // The loop is left from its condition, so what was known at the top is known after it
+                    map<string, int> before = available;
+                    map<Variable, int> topVersions = versions;
+                    numberBlock(statement->getChild(1), scope->getChild(scopeIndex));
+                    available = before;
+                    versions = topVersions;
+                    scopeIndex++;
+                }
+            }
+        }
+
+        // Numbers an expression, noting where it computes a value that is already available
+        // A match is reused as a whole, so the expressions inside it aren't looked at
+        void numberExpression(Node* node, HashNode* scope, const bool canBeFirst)
+        {
+            if (node->isLeaf())
+            {
+                return;
+            }
+
+            string key = keyOf(node, scope);
+            auto found = available.find(key);
+            if (found != available.end())
+            {
+                values[found->second].uses.emplace_back(node);
+                return;
+            }
+
+            if (canBeFirst)
+            {
+                values.emplace_back(node);
+                available[key] = values.size() - 1;
+            }
+
+            for (Node* child : node->getChildren())
+            {
+                numberExpression(child, scope, canBeFirst);
+            }
+        }
+
+        // Key that is the same for every expression with the same value (ADD, isEq, and isNotEq don't care about order)
+        string keyOf(Node* node, HashNode* scope)
+        {
+            if (node->isLeaf())
+            {
+                if (node->getToken()->getType() == "ID")
+                {
+                    return "#" + to_string(versions[resolve(node->getName(), scope)]);
+                }
+                return node->getToken()->getType() + ":" + node->getName();
+            }
+
+            string first = keyOf(node->getChild(0), scope);
+            string second = keyOf(node->getChild(1), scope);
+            if (second < first)
+            {
+                swap(first, second);
+            }
+            return node->getName() + "(" + first + "," + second + ")";
+        }
+
+        // Gives every variable assigned (or declared) in a Block a new number, since it could have changed
+        void changeAssigned(Node* node)
+        {
+            string name = node->getName();
+            string varName = "";
+            if (name == "Assign")
+            {
+                varName = node->getChild(0)->getName();
+            }
+            else if (name == "Declare")
+            {
+                varName = node->getChild(1)->getName();
+            }
+
+            if (varName != "")
+            {
+                for (auto& entry : versions)
+                {
+                    if (entry.first.second == varName)
+                    {
+                        entry.second = versionCount++;
+                    }
+                }
+                return;
+            }
+
+            if (!node->isLeaf())
+            {
+                for (Node* child : node->getChildren())
+                {
+                    changeAssigned(child);
+                }
+            }
+        }
+
+        // Finds the variable a name refers to from a scope (the closest declaration that came before)
+        Variable resolve(const string varName, HashNode* scope)
+        {
+            HashNode* node = scope;
+            while (node && declared.find(Variable(node, varName)) == declared.end())
+            {
+                node = node->getParent();
+            }
+            return Variable(node, varName);
+        }
+
+        // Stores a value in a new variable right before the statement that first computes it, and reads the variable everywhere it is computed
+        int reuse(Value& value)
+        {
+            if (value.uses.empty())
+            {
+                return 0;
+            }
+
+            // Every later computation is replaced with a load, which has to pay for storing the value
+            int uses = value.uses.size();
+            if (uses * (cost(value.first) - LOAD_COST) <= STORE_COST + STATIC_COST)
+            {
+                return 0;
+            }
+
+            // Sums are ints and comparisons are booleans
+            string type = "boolean";
+            if (value.first->getName() == "ADD")
+            {
+                type = "int";
+            }
+
+            Token* token = value.first->getToken();
+            string varName = "$v" + to_string(tempCount);
+            tempCount++;
+            log("DEBUG", "Common Subexpressions: Storing " + value.first->getName() + " at (" + location(value.first) + ") in [" + varName + "] for " + to_string(uses) + " later use(s)");
+
+            // The statement the value is first computed in (it could have been moved into the assignment of another new variable)
+            Node* statement = value.first;
+            while (statement->getParent()->getName() != "Block")
+            {
+                statement = statement->getParent();
+            }
+            Node* block = statement->getParent();
+
+            // Add the variable to the scope of the Block
+            HashNode* scope = blockScopes[block];
+            scope->addValue(varName, type);
+            scope->setLineAndColumn(varName, token->getLine(), token->getColumn());
+            scope->setInitialized(varName);
+            scope->setUsed(varName);
+
+            // Read the variable where the value was first computed, and store it right before that statement
+            value.first->getParent()->replaceChild(value.first, newLeaf("ID", varName, token));
+
+            Node* declare = new Node();
+            declare->setName("Declare");
+            addChild(declare, newLeaf(typeTokenName(type), type, token));
+            addChild(declare, newLeaf("ID", varName, token));
+            block->insertChild(statement, declare);
+
+            Node* assign = new Node();
+            assign->setName("Assign");
+            addChild(assign, newLeaf("ID", varName, token));
+            addChild(assign, value.first);
+            block->insertChild(statement, assign);
+
+            // Read the variable everywhere else
+            for (Node* use : value.uses)
+            {
+                log("DEBUG", "Common Subexpressions: Replacing " + use->getName() + " at (" + location(use) + ") with [" + varName + "]");
+                use->getParent()->replaceChild(use, newLeaf("ID", varName, use->getToken()));
+                deleteNode(use);
+            }
+            return uses;
+        }
+
+        // Rough number of bytes Code Gen writes for an expression
+        int cost(Node* node)
+        {
+            if (node->isLeaf())
+            {
+                return 0;
+            }
+
+            // Load, add, and store for a sum, or a compare and the loads that turn it into true/false
+            int total = 8;
+            if (node->getName() != "ADD")
+            {
+                total = 11;
+            }
+
+            for (Node* child : node->getChildren())
+            {
+                total += cost(child);
+            }
+            return total;
+        }
+
+        // Creates a new leaf with its own token (at the position of another token)
+        Node* newLeaf(const string tokenType, const string value, Token* position)
+        {
+            newTokens.emplace_back(tokenType, value, position->getLine(), position->getColumn());
+
+            Node* leaf = new Node();
+            leaf->setName(value);
+            leaf->setToLeaf();
+            leaf->linkToken(&newTokens.back());
+            return leaf;
+        }
+
+        // Adds a child to a Node and links it back to its new parent
+        void addChild(Node* parent, Node* child)
+        {
+            parent->addChild(child);
+            child->setParent(parent);
+        }
+
+        // Token type the Lexer gives to a type keyword
+        string typeTokenName(const string type)
+        {
+            if (type == "int")
+            {
+                return "I_VARTYPE";
+            }
+            return "B_VARTYPE";
+        }
+
+        // Line and column of a Node's token
+        string location(Node* node)
+        {
+            Token* token = node->getToken();
+            return to_string(token->getLine()) + ":" + to_string(token->getColumn());
+        }
+
+        // Deletes a removed part of the AST
+        void deleteNode(Node* node)
+        {
+            for (Node* child : node->getChildren())
+            {
+                deleteNode(child);
+            }
+            delete(node);
+        }
+
+        // Logging function for the optimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Optimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
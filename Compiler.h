@@ -0,0 +1,176 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+using namespace std;
+
+// Runs a single program through every stage of the compiler (lex, parse, semantic analysis, then optimization and Code Gen)
+// The front end only runs once, so a program can be built with more than one set of options (like every variant the diff harness compares)
+class Compiler
+{
+    public:
+        // Default constructor for the Compiler class
+        Compiler(const int progNum, const string progSource, const char progDelimiter, Options progOptions)
+        {
+            this->programNumber = progNum;
+            this->source = progSource;
+            this->delimiter = progDelimiter;
+            this->options = progOptions;
+        }
+
+        // Compiles the program, returns "compiled" or the kind of error that stopped it (lex, parse, semantic, code gen, or memory error if it didn't fit)
+        string compile()
+        {
+            return compileEach({options})[0];
+        }
+
+        // Compiles the program with each set of options, returns the result for each one like compile does
+        vector<string> compileEach(const vector<Options>& settings)
+        {
+            builds.assign(settings.size(), Build());
+
+            cout << endl;
+            int errors = 0;
+            
+            // LEXER
+            Lexer currentLex = Lexer(programNumber, source, delimiter);
+            auto lexResult = currentLex.tokenize();
+            vector<Token> tokens = lexResult.first;
+            errors = lexResult.second;
+
+            cout << endl;
+
+            // PARSER
+            if (errors > 0 || tokens.size() == 0)
+            {
+                log("INFO", "Parsing for Program #" + to_string(programNumber) + " skipped due to Lex error(s)");
+                return vector<string>(settings.size(), "lex error");
+            }
+
+            Parser currentParse = Parser(programNumber, tokens, delimiter);
+            currentParse.parse();
+            errors = currentParse.getErrors();
+
+            cout << endl;
+
+            // CST
+            if (errors > 0)
+            {
+                log("INFO", "CST for Program #" + to_string(programNumber) + " skipped due to Parse error(s)");
+                currentParse.deleteCST();
+                return vector<string>(settings.size(), "parse error");
+            }
+
+            Tree* currentCST = currentParse.getCST();
+            
+            if (VERBOSE)
+            {
+                log("INFO", "CST for Program #" + to_string(programNumber));
+                currentParse.printCST();
+            }
+
+            // SEMANTIC ANALYSIS
+            SemanticAnalyzer currentAnalyzer = SemanticAnalyzer(programNumber, currentCST);
+            currentAnalyzer.generate();
+            currentAnalyzer.traverseSymbolTable();
+
+            cout << endl;
+
+            currentAnalyzer.printAST();
+            errors = currentAnalyzer.getErrors();
+
+            if (errors > 0)
+            {
+                log("INFO", "Symbol Table for Program #" + to_string(programNumber) + " skipped due to Semantic Analysis error(s)");
+                currentParse.deleteCST();
+                currentAnalyzer.deleteAST();
+                currentAnalyzer.deleteSymbolTable();
+                return vector<string>(settings.size(), "semantic error");
+            }
+            currentAnalyzer.printSymbolTable();
+
+            Tree* currentAST = currentAnalyzer.getAST();
+            SymbolTable* currentSymbolTable = currentAnalyzer.getSymbolTable();
+
+            cout << endl;
+
+            // OPTIMIZATION AND CODE GEN (starts over at smaller levels if the program doesn't fit in memory)
+            // The optimizer works on a copy of the AST, so every set of options starts from the same one
+            vector<string> results;
+            for (int i = 0, n = settings.size(); i < n; i++)
+            {
+                Optimizer currentOptimizer = Optimizer(programNumber, currentAST, currentSymbolTable, settings[i]);
+                currentOptimizer.compile();
+                builds[i] = currentOptimizer.getBuild();
+
+                if (builds[i].overflowed)
+                {
+                    results.emplace_back("memory error");
+                }
+                else if (builds[i].image.empty())
+                {
+                    results.emplace_back("code gen error");
+                }
+                else
+                {
+                    results.emplace_back("compiled");
+                }
+            }
+
+            // PROPER MEMORY MANAGEMENT
+            currentParse.deleteCST();
+            currentAnalyzer.deleteAST();
+            currentAnalyzer.deleteSymbolTable();
+
+            return results;
+        }
+
+        // Getter for what Code Gen placed with the first set of options (the image is empty unless the program compiled)
+        Build getBuild()
+        {
+            return this->builds[0];
+        }
+
+        // Getter for what Code Gen placed with each set of options
+        vector<Build> getBuilds()
+        {
+            return this->builds;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        string source;
+        char delimiter;
+        Options options;
+        vector<Build> builds;
+
+        // Logging function for the compiler
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Compiler - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,256 @@
+#ifndef CONSTANTFOLDER_H
+#define CONSTANTFOLDER_H
+
+using namespace std;
+
+// Folds constant expressions in the AST and removes branches that can never run (runs between Semantic Analysis and Code Gen)
+class ConstantFolder
+{
+    public:
+        // Default constructor for the ConstantFolder class
+        ConstantFolder(const int progNum, Tree* progAST, SymbolTable* progSymTable)
+        {
+            this->programNumber = progNum;
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+        }
+
+        // Folds the whole program, returns how many expressions and branches were changed
+        int fold()
+        {
+            foldCount = 0;
+            removedCount = 0;
+
+            foldBlock(myAST->getRoot(), mySymTable->getRoot());
+            log("DEBUG", "Constant Folding: Folded " + to_string(foldCount) + " expression(s) and removed " + to_string(removedCount) + " branch(es) in Program #" + to_string(programNumber));
+            return foldCount + removedCount;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Tree* myAST;
+        SymbolTable* mySymTable;
+
+        // Tokens for the new leaf Nodes (deque so pointers to them stay valid)
+        deque<Token> foldedTokens;
+
+        int foldCount = 0;
+        int removedCount = 0;
+
+        // Folds every statement in a Block (scope is the Symbol Table scope that belongs to the Block)
+        void foldBlock(Node* block, HashNode* scope)
+        {
+            // Child scopes are in the same order as the Blocks inside this one
+            int scopeIndex = 0;
+
+            for (Node* statement : block->getChildren())
+            {
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    foldBlock(statement, scope->getChild(scopeIndex));
+                    scopeIndex++;
+                }
+                else if (name == "Assign")
+                {
+                    foldExpression(statement->getChild(1));
+                }
+                else if (name == "Print")
+                {
+                    foldExpression(statement->getChild(0));
+                }
+                else if (name == "If" || name == "While")
+                {
+                    foldExpression(statement->getChild(0));
+
+                    Node* condition = statement->getChild(0);
+                    Node* body = statement->getChild(1);
+                    HashNode* bodyScope = scope->getChild(scopeIndex);
+
+                    // Branch can never run, so remove it along with its scope
+                    if (condition->getName() == "false")
+                    {
+                        log("DEBUG", "Constant Folding: Removing " + name + " with a false condition at (" + location(condition) + ")");
+                        block->removeChild(statement);
+                        deleteNode(statement);
+                        scope->removeChild(bodyScope);
+                        deleteHashNode(bodyScope);
+                        removedCount++;
+                        continue;
+                    }
+
+                    // If always runs, so it's just a Block
+                    if (condition->getName() == "true" && name == "If")
+                    {
+                        log("DEBUG", "Constant Folding: Replacing If with a true condition at (" + location(condition) + ") with its Block");
+                        block->replaceChild(statement, body);
+                        statement->removeChild(body);
+                        deleteNode(statement);
+                        removedCount++;
+                    }
+
+                    foldBlock(body, bodyScope);
+                    scopeIndex++;
+                }
+            }
+        }
+
+        // Folds an expression from the bottom up
+        void foldExpression(Node* node)
+        {
+            if (node->isLeaf())
+            {
+                return;
+            }
+
+            // Fold the children first
+            for (Node* child : node->getChildren())
+            {
+                foldExpression(child);
+            }
+
+            string name = node->getName();
+            Node* first = node->getChild(0);
+            Node* second = node->getChild(1);
+
+            if (name == "ADD")
+            {
+                // Both values are known (sums wrap around like they do in the accumulator)
+                if (isIntLiteral(first) && isIntLiteral(second))
+                {
+                    int sum = (stoi(first->getName()) + stoi(second->getName())) % 0x100;
+                    replaceWithLiteral(node, "DIGIT", to_string(sum));
+                }
+                // The sum of the first two values in a nested addition is known (1 + 2 + a becomes 3 + a)
+                else if (isIntLiteral(first) && second->getName() == "ADD" && isIntLiteral(second->getChild(0)))
+                {
+                    int sum = (stoi(first->getName()) + stoi(second->getChild(0)->getName())) % 0x100;
+                    log("DEBUG", "Constant Folding: Combining " + first->getName() + " + " + second->getChild(0)->getName() + " at (" + location(node) + ")");
+
+                    // Update the first value, then take the place of the nested addition
+                    replaceWithLiteral(first, "DIGIT", to_string(sum));
+                    Node* rest = second->getChild(1);
+                    second->removeChild(rest);
+                    node->replaceChild(second, rest);
+                    deleteNode(second);
+                }
+            }
+            else if (name == "isEq" || name == "isNotEq")
+            {
+                // Semantic Analysis made sure the types match, so literals with the same name are equal
+                if (isLiteral(first) && isLiteral(second))
+                {
+                    bool equal = first->getName() == second->getName();
+                    if (name == "isNotEq")
+                    {
+                        equal = !equal;
+                    }
+
+                    if (equal)
+                    {
+                        replaceWithLiteral(node, "BOOL_VAL", "true");
+                    }
+                    else
+                    {
+                        replaceWithLiteral(node, "BOOL_VAL", "false");
+                    }
+                }
+            }
+        }
+
+        // Replaces a Node with a new leaf that has its own token
+        void replaceWithLiteral(Node* node, const string tokenType, const string value)
+        {
+            log("DEBUG", "Constant Folding: Replacing " + node->getName() + " at (" + location(node) + ") with [" + value + "]");
+
+            Token* oldToken = node->getToken();
+            foldedTokens.emplace_back(tokenType, value, oldToken->getLine(), oldToken->getColumn());
+
+            // Create the new leaf
+            Node* leaf = new Node();
+            leaf->setName(value);
+            leaf->setToLeaf();
+            leaf->linkToken(&foldedTokens.back());
+
+            // Take the place of the old Node
+            node->getParent()->replaceChild(node, leaf);
+            deleteNode(node);
+            foldCount++;
+        }
+
+        // Returns whether or not a Node is a literal (int, boolean, or string)
+        bool isLiteral(Node* node)
+        {
+            if (!node->isLeaf())
+            {
+                return false;
+            }
+            string tokenType = node->getToken()->getType();
+            return tokenType != "ID";
+        }
+
+        // Returns whether or not a Node is an int literal
+        bool isIntLiteral(Node* node)
+        {
+            return node->isLeaf() && node->getToken()->getType() == "DIGIT";
+        }
+
+        // Line and column of a Node's token
+        string location(Node* node)
+        {
+            Token* token = node->getToken();
+            return to_string(token->getLine()) + ":" + to_string(token->getColumn());
+        }
+
+        // Deletes a removed part of the AST
+        void deleteNode(Node* node)
+        {
+            for (Node* child : node->getChildren())
+            {
+                deleteNode(child);
+            }
+            delete(node);
+        }
+
+        // Deletes a removed part of the Symbol Table
+        void deleteHashNode(HashNode* node)
+        {
+            for (HashNode* child : node->getChildren())
+            {
+                deleteHashNode(child);
+            }
+            delete(node);
+        }
+
+        // Logging function for the optimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Optimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,353 @@
+#ifndef CONSTANTPROPAGATOR_H
+#define CONSTANTPROPAGATOR_H
+
+using namespace std;
+
+// Replaces reads of variables whose value is known (a literal or a copy of another variable) as the AST is walked in program order
+// Knowledge is merged where an If rejoins, and anything a While assigns is forgotten at the top of the loop (the back edge)
+class ConstantPropagator
+{
+    public:
+        // Default constructor for the ConstantPropagator class
+        ConstantPropagator(const int progNum, Tree* progAST, SymbolTable* progSymTable)
+        {
+            this->programNumber = progNum;
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+        }
+
+        // Propagates through the whole program, returns how many reads were replaced
+        int propagate()
+        {
+            state.clear();
+            declared.clear();
+            constantCount = 0;
+            copyCount = 0;
+
+            propagateBlock(myAST->getRoot(), mySymTable->getRoot());
+            log("DEBUG", "Propagation: Replaced " + to_string(constantCount) + " read(s) with constants and " + to_string(copyCount) + " read(s) with copies in Program #" + to_string(programNumber));
+            return constantCount + copyCount;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Tree* myAST;
+        SymbolTable* mySymTable;
+
+        // A variable is its name and the scope it was declared in
+        typedef pair<HashNode*, string> Variable;
+
+        // What is known about a variable's value (a literal, or the same value as another variable)
+        struct Known
+        {
+            bool isCopy;
+            string value;
+            string tokenType;
+            Variable source;
+
+            // Constructor for a literal
+            Known(const string v, const string t)
+            {
+                isCopy = false;
+                value = v;
+                tokenType = t;
+                source = Variable(nullptr, "");
+            }
+
+            // Constructor for a copy
+            Known(const Variable s)
+            {
+                isCopy = true;
+                value = s.second;
+                tokenType = "ID";
+                source = s;
+            }
+
+            bool operator==(const Known& other) const
+            {
+                return isCopy == other.isCopy && value == other.value && tokenType == other.tokenType && source == other.source;
+            }
+        };
+
+        // Known values at the current point in the program
+        typedef map<Variable, Known> State;
+        State state;
+
+        // Variables declared so far (a variable can't be read before its declaration, even if its scope already has it)
+        set<Variable> declared;
+
+        // Tokens for the new leaf Nodes (deque so pointers to them stay valid)
+        deque<Token> propagatedTokens;
+
+        int constantCount = 0;
+        int copyCount = 0;
+
+        // Propagates through every statement in a Block (scope is the Symbol Table scope that belongs to the Block)
+        void propagateBlock(Node* block, HashNode* scope)
+        {
+            // Child scopes are in the same order as the Blocks inside this one
+            int scopeIndex = 0;
+
+            for (Node* statement : block->getChildren())
+            {
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    propagateBlock(statement, scope->getChild(scopeIndex));
+                    scopeIndex++;
+                }
+                else if (name == "Declare")
+                {
+                    // Ints and booleans start out as 0 (false), strings point to nothing
+                    string type = statement->getChild(0)->getName();
+                    Variable var = Variable(scope, statement->getChild(1)->getName());
+                    declared.insert(var);
+                    forget(var);
+
+                    if (type == "int")
+                    {
+                        state.emplace(var, Known("0", "DIGIT"));
+                    }
+                    else if (type == "boolean")
+                    {
+                        state.emplace(var, Known("false", "BOOL_VAL"));
+                    }
+                }
+                else if (name == "Assign")
+                {
+                    replaceReads(statement->getChild(1), scope);
+
+                    Variable target = resolve(statement->getChild(0)->getName(), scope);
+                    Node* value = statement->getChild(1);
+                    forget(target);
+
+                    // Only leaves are known (expressions get folded into leaves if they can be)
+                    if (value->isLeaf())
+                    {
+                        string tokenType = value->getToken()->getType();
+                        if (tokenType != "ID")
+                        {
+                            state.emplace(target, Known(value->getName(), tokenType));
+                        }
+                        else
+                        {
+                            Variable source = resolve(value->getName(), scope);
+                            if (source != target)
+                            {
+                                state.emplace(target, Known(source));
+                            }
+                        }
+                    }
+                }
+                else if (name == "Print")
+                {
+                    replaceReads(statement->getChild(0), scope);
+                }
+                else if (name == "If")
+                {
+                    replaceReads(statement->getChild(0), scope);
+
+                    // The block might not run, so only what is known either way is kept
+                    State before = state;
+                    propagateBlock(statement->getChild(1), scope->getChild(scopeIndex));
+                    merge(before);
+                    scopeIndex++;
+                }
+                else if (name == "While")
+                {
+                    // The top of the loop can be reached from the end of the block, so forget everything it assigns
+                    set<string> assigned;
+                    collectAssigned(statement->getChild(1), assigned);
+                    for (const string& varName : assigned)
+                    {
+                        forgetName(varName);
+                    }
+
+                    replaceReads(statement->getChild(0), scope);
+
+                    // The loop is left from its condition, so what was known at the top is known after it
+                    State top = state;
+                    propagateBlock(statement->getChild(1), scope->getChild(scopeIndex));
+                    state = top;
+                    scopeIndex++;
+                }
+            }
+        }
+
+        // Replaces every variable read in an expression that has a known value
+        void replaceReads(Node* node, HashNode* scope)
+        {
+            if (!node->isLeaf())
+            {
+                for (Node* child : node->getChildren())
+                {
+                    replaceReads(child, scope);
+                }
+                return;
+            }
+
+            if (node->getToken()->getType() != "ID")
+            {
+                return;
+            }
+
+            Variable var = resolve(node->getName(), scope);
+            auto found = state.find(var);
+            if (found == state.end())
+            {
+                return;
+            }
+            Known known = found->second;
+
+            // A copy can only be used if its name still means the same variable here (it could be hidden by another declaration)
+            if (known.isCopy)
+            {
+                if (resolve(known.value, scope) != known.source)
+                {
+                    return;
+                }
+                log("DEBUG", "Copy Propagation: Replacing [" + node->getName() + "] at (" + location(node) + ") with [" + known.value + "]");
+                copyCount++;
+            }
+            else
+            {
+                log("DEBUG", "Constant Propagation: Replacing [" + node->getName() + "] at (" + location(node) + ") with [" + known.value + "]");
+                constantCount++;
+            }
+
+            Token* oldToken = node->getToken();
+            propagatedTokens.emplace_back(known.tokenType, known.value, oldToken->getLine(), oldToken->getColumn());
+
+            // Create the new leaf and take the place of the read
+            Node* leaf = new Node();
+            leaf->setName(known.value);
+            leaf->setToLeaf();
+            leaf->linkToken(&propagatedTokens.back());
+            node->getParent()->replaceChild(node, leaf);
+            delete(node);
+        }
+
+        // Finds the variable a name refers to from a scope (the closest declaration that came before)
+        Variable resolve(const string varName, HashNode* scope)
+        {
+            HashNode* node = scope;
+            while (node && declared.find(Variable(node, varName)) == declared.end())
+            {
+                node = node->getParent();
+            }
+            return Variable(node, varName);
+        }
+
+        // Forgets a variable's value, along with any copies of it
+        void forget(const Variable var)
+        {
+            state.erase(var);
+            for (auto it = state.begin(); it != state.end();)
+            {
+                if (it->second.isCopy && it->second.source == var)
+                {
+                    it = state.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        // Forgets every variable with a name, and every copy of a variable with that name (used when it isn't known which scope
+        // an assignment refers to, and its source can be copied without having a known value itself)
+        void forgetName(const string varName)
+        {
+            for (auto it = state.begin(); it != state.end();)
+            {
+                if (it->first.second == varName || (it->second.isCopy && it->second.source.second == varName))
+                {
+                    it = state.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        // Keeps only what is known the same way in both states (where two paths join)
+        void merge(const State& other)
+        {
+            for (auto it = state.begin(); it != state.end();)
+            {
+                auto found = other.find(it->first);
+                if (found == other.end() || !(found->second == it->second))
+                {
+                    it = state.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        // Collects the name of every variable assigned (or redeclared) inside a Block, including nested ones
+        void collectAssigned(Node* node, set<string>& assigned)
+        {
+            string name = node->getName();
+            if (name == "Assign")
+            {
+                assigned.insert(node->getChild(0)->getName());
+                return;
+            }
+            else if (name == "Declare")
+            {
+                assigned.insert(node->getChild(1)->getName());
+                return;
+            }
+            if (!node->isLeaf())
+            {
+                for (Node* child : node->getChildren())
+                {
+                    collectAssigned(child, assigned);
+                }
+            }
+        }
+
+        // Line and column of a Node's token
+        string location(Node* node)
+        {
+            Token* token = node->getToken();
+            return to_string(token->getLine()) + ":" + to_string(token->getColumn());
+        }
+
+        // Logging function for the optimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Optimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
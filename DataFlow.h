@@ -0,0 +1,807 @@
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+using namespace std;
+
+// A set of small integers (definitions, variables, or temps), 64 to a word
+class BitVector
+{
+    public:
+        // Default constructor for the BitVector class
+        BitVector(const int bitCount = 0)
+        {
+            this->size = bitCount;
+            words.assign((bitCount + 63) / 64, 0);
+        }
+
+        // Adds or removes a single bit
+        void set(const int bit)
+        {
+            words[bit / 64] |= (uint64_t)1 << (bit % 64);
+        }
+
+        void reset(const int bit)
+        {
+            words[bit / 64] &= ~((uint64_t)1 << (bit % 64));
+        }
+
+        // Whether or not a bit is in the set
+        bool test(const int bit) const
+        {
+            return (words[bit / 64] >> (bit % 64)) & 1;
+        }
+
+        // Puts every bit in the set
+        void fill()
+        {
+            for (uint64_t& word : words)
+            {
+                word = ~(uint64_t)0;
+            }
+            if (size % 64 && !words.empty())
+            {
+                words.back() = ((uint64_t)1 << (size % 64)) - 1;
+            }
+        }
+
+        // Set operations in place (union, intersection, and difference)
+        void unite(const BitVector& other)
+        {
+            for (int i = 0, n = words.size(); i < n; i++)
+            {
+                words[i] |= other.words[i];
+            }
+        }
+
+        void intersect(const BitVector& other)
+        {
+            for (int i = 0, n = words.size(); i < n; i++)
+            {
+                words[i] &= other.words[i];
+            }
+        }
+
+        void subtract(const BitVector& other)
+        {
+            for (int i = 0, n = words.size(); i < n; i++)
+            {
+                words[i] &= ~other.words[i];
+            }
+        }
+
+        // Number of bits in the set
+        int count() const
+        {
+            int total = 0;
+            for (uint64_t word : words)
+            {
+                total += __builtin_popcountll(word);
+            }
+            return total;
+        }
+
+        bool operator==(const BitVector& other) const
+        {
+            return words == other.words;
+        }
+
+        bool operator!=(const BitVector& other) const
+        {
+            return words != other.words;
+        }
+
+    private:
+        // Default members
+        int size;
+        vector<uint64_t> words;
+};
+
+// The edges between the basic blocks of a program in IR (the If/While/Block structure of the AST after lowering)
+// A block goes to the one its branch names, and falls into the next one unless it ends with a jump
+class ControlFlowGraph
+{
+    public:
+        // Default constructor for the ControlFlowGraph class
+        ControlFlowGraph(IRProgram& progIR)
+        {
+            vector<IRBlock>& blocks = progIR.getBlocks();
+            int blockCount = blocks.size();
+            successors.assign(blockCount, vector<int>());
+            predecessors.assign(blockCount, vector<int>());
+
+            unordered_map<int, int> labels;
+            for (int i = 0; i < blockCount; i++)
+            {
+                labels[blocks[i].label] = i;
+            }
+            for (int i = 0; i < blockCount; i++)
+            {
+                bool fallsThrough = i + 1 < blockCount;
+                if (!blocks[i].instructions.empty() && blocks[i].instructions.back().isBranch())
+                {
+                    const IRInstruction& branch = blocks[i].instructions.back();
+                    addEdge(i, labels[branch.label]);
+                    if (branch.op == "jump")
+                    {
+                        fallsThrough = false;
+                    }
+                }
+                if (fallsThrough)
+                {
+                    addEdge(i, i + 1);
+                }
+            }
+            findOrder();
+        }
+
+        // Getters
+        vector<int>& getSuccessors(const int block)
+        {
+            return this->successors[block];
+        }
+
+        vector<int>& getPredecessors(const int block)
+        {
+            return this->predecessors[block];
+        }
+
+        // Blocks in reverse postorder from the first one (blocks it can't reach come last)
+        vector<int>& getOrder()
+        {
+            return this->order;
+        }
+
+        int size()
+        {
+            return this->successors.size();
+        }
+
+    private:
+        // Default members
+        vector<vector<int>> successors;
+        vector<vector<int>> predecessors;
+        vector<int> order;
+
+        // Adds an edge (an If without a block can branch to the block it falls into)
+        void addEdge(const int from, const int to)
+        {
+            if (find(successors[from].begin(), successors[from].end(), to) == successors[from].end())
+            {
+                successors[from].emplace_back(to);
+                predecessors[to].emplace_back(from);
+            }
+        }
+
+        // Depth first search without recursion, since generated programs can nest deep enough to run out of stack
+        void findOrder()
+        {
+            int blockCount = successors.size();
+            vector<bool> visited(blockCount, false);
+            for (int root = 0; root < blockCount; root++)
+            {
+                if (visited[root])
+                {
+                    continue;
+                }
+
+                // Each entry is a block and the index of the next successor to visit
+                vector<int> postorder;
+                vector<pair<int, int>> stack = {{root, 0}};
+                visited[root] = true;
+                while (!stack.empty())
+                {
+                    int block = stack.back().first;
+                    int next = stack.back().second;
+                    if (next < (int)successors[block].size())
+                    {
+                        stack.back().second++;
+                        int successor = successors[block][next];
+                        if (!visited[successor])
+                        {
+                            visited[successor] = true;
+                            stack.emplace_back(successor, 0);
+                        }
+                    }
+                    else
+                    {
+                        postorder.emplace_back(block);
+                        stack.pop_back();
+                    }
+                }
+                order.insert(order.end(), postorder.rbegin(), postorder.rend());
+            }
+        }
+};
+
+// The sets at the start and end of every block once a problem is solved
+struct DataFlowResult
+{
+    vector<BitVector> in;
+    vector<BitVector> out;
+};
+
+// A dataflow problem over the blocks of a CFG: what each block adds (gen) and removes (kill),
+// whether facts flow forward or backward, and whether they meet with union (may) or intersection (must)
+struct DataFlowProblem
+{
+    bool forward;
+    bool intersect;
+    int bitCount;
+    vector<BitVector> gen;
+    vector<BitVector> kill;
+
+    // Set on entry to the first block (forward) or exit from the last ones (backward)
+    BitVector boundary;
+
+    // Constructor for struct
+    DataFlowProblem(const bool f, const bool i, const int bits, const int blockCount)
+    {
+        forward = f;
+        intersect = i;
+        bitCount = bits;
+        gen.assign(blockCount, BitVector(bits));
+        kill.assign(blockCount, BitVector(bits));
+        boundary = BitVector(bits);
+    }
+};
+
+// Solves dataflow problems over the CFG of a program in IR with a worklist of blocks,
+// and runs liveness, reaching definitions, and definite assignment on it
+// Blocks start in reverse postorder (postorder for backward problems) and are only visited again when a block they depend on changes,
+// so the structured loops of the language settle after a pass or two and solving stays linear in the size of the program
+class DataFlow
+{
+    public:
+        // Default constructor for the DataFlow class
+        DataFlow(IRProgram& progIR) : program(progIR), cfg(progIR)
+        {
+            variableCount = program.getSymbols().size();
+            valueCount = variableCount + program.getTempCount();
+            numberDefinitions();
+        }
+
+        // Solves a problem, returning the sets at the start and end of every block
+        DataFlowResult solve(DataFlowProblem& problem)
+        {
+            int blockCount = cfg.size();
+            DataFlowResult result;
+            result.in.assign(blockCount, BitVector(problem.bitCount));
+            result.out.assign(blockCount, BitVector(problem.bitCount));
+
+            // Must problems start from everything and narrow down, may problems start from nothing and grow
+            if (problem.intersect)
+            {
+                for (int i = 0; i < blockCount; i++)
+                {
+                    result.in[i].fill();
+                    result.out[i].fill();
+                }
+            }
+
+            // Facts come into a block on one side and leave it on the other
+            vector<BitVector>* before = &result.in;
+            vector<BitVector>* after = &result.out;
+            vector<int> order = cfg.getOrder();
+            if (!problem.forward)
+            {
+                swap(before, after);
+                reverse(order.begin(), order.end());
+            }
+            deque<int> worklist(order.begin(), order.end());
+            vector<bool> queued(blockCount, true);
+            visits = 0;
+
+            while (!worklist.empty())
+            {
+                int block = worklist.front();
+                worklist.pop_front();
+                queued[block] = false;
+                visits++;
+
+                // Meet what flows in from the neighbours (the boundary flows into the entry or the exits)
+                vector<int>* sources = &cfg.getPredecessors(block);
+                vector<int>* targets = &cfg.getSuccessors(block);
+                if (!problem.forward)
+                {
+                    swap(sources, targets);
+                }
+                bool atBoundary = (problem.forward && block == 0) || (!problem.forward && sources->empty());
+                BitVector meet = BitVector(problem.bitCount);
+                if (problem.intersect && !atBoundary && !sources->empty())
+                {
+                    meet.fill();
+                }
+                if (atBoundary)
+                {
+                    meet = problem.boundary;
+                }
+                for (int source : *sources)
+                {
+                    if (problem.intersect)
+                    {
+                        meet.intersect((*after)[source]);
+                    }
+                    else
+                    {
+                        meet.unite((*after)[source]);
+                    }
+                }
+                (*before)[block] = meet;
+
+                // Transfer: gen, plus whatever came in that wasn't killed
+                BitVector transferred = meet;
+                transferred.subtract(problem.kill[block]);
+                transferred.unite(problem.gen[block]);
+                if (transferred != (*after)[block])
+                {
+                    (*after)[block] = transferred;
+                    for (int target : *targets)
+                    {
+                        if (!queued[target])
+                        {
+                            queued[target] = true;
+                            worklist.emplace_back(target);
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+
+        // Values (variables, then temps) that can still be read before they are written again, backward with union
+        DataFlowResult liveness()
+        {
+            vector<IRBlock>& blocks = program.getBlocks();
+            DataFlowProblem problem = DataFlowProblem(false, false, valueCount, blocks.size());
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                // Walk the block backward: a write ends a value's life, a read starts it
+                for (int i = blocks[b].instructions.size() - 1; i >= 0; i--)
+                {
+                    IRInstruction& instruction = blocks[b].instructions[i];
+                    int dest = valueIndex(instruction.dest);
+                    if (dest >= 0)
+                    {
+                        problem.kill[b].set(dest);
+                        problem.gen[b].reset(dest);
+                    }
+                    for (const IRValue& read : {instruction.first, instruction.second})
+                    {
+                        if (valueIndex(read) >= 0)
+                        {
+                            problem.gen[b].set(valueIndex(read));
+                        }
+                    }
+                }
+            }
+            return solve(problem);
+        }
+
+        // Definitions (every instruction that writes a variable or temp) that can reach a point without being written over, forward with union
+        DataFlowResult reachingDefinitions()
+        {
+            vector<IRBlock>& blocks = program.getBlocks();
+            DataFlowProblem problem = DataFlowProblem(true, false, definitionCount, blocks.size());
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                // The last definition of each value in the block reaches its end, and kills every other definition of the value
+                unordered_map<int, int> lastDefinitions;
+                for (int i = 0, m = blocks[b].instructions.size(); i < m; i++)
+                {
+                    int dest = valueIndex(blocks[b].instructions[i].dest);
+                    if (dest >= 0)
+                    {
+                        lastDefinitions[dest] = definitionIds[b][i];
+                    }
+                }
+                for (auto& last : lastDefinitions)
+                {
+                    for (int definition : definitionsOf[last.first])
+                    {
+                        problem.kill[b].set(definition);
+                    }
+                    problem.gen[b].set(last.second);
+                }
+            }
+            return solve(problem);
+        }
+
+        // Variables that were assigned on every path to a point, forward with intersection
+        // Declaring a variable gives it a 0, but only an assignment counts, and declaring it again (in a loop) takes the assignment away
+        DataFlowResult definiteAssignment()
+        {
+            vector<IRBlock>& blocks = program.getBlocks();
+            DataFlowProblem problem = DataFlowProblem(true, true, variableCount, blocks.size());
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                for (IRInstruction& instruction : blocks[b].instructions)
+                {
+                    if (instruction.dest.kind != 'v')
+                    {
+                        continue;
+                    }
+                    if (isDeclaration(instruction))
+                    {
+                        problem.kill[b].set(instruction.dest.index);
+                        problem.gen[b].reset(instruction.dest.index);
+                    }
+                    else
+                    {
+                        problem.gen[b].set(instruction.dest.index);
+                        problem.kill[b].reset(instruction.dest.index);
+                    }
+                }
+            }
+            return solve(problem);
+        }
+
+        // Warns about reads of a variable that wasn't assigned on every path to them
+        // Semantic Analysis already reports reads that come before the first assignment in the source, so only the ones after it are checked
+        int warnUninitialized()
+        {
+            const int unassigned = -1;
+            vector<int> firstAssigned(variableCount, unassigned);
+            int position = 0;
+            for (IRBlock& block : program.getBlocks())
+            {
+                for (IRInstruction& instruction : block.instructions)
+                {
+                    if (instruction.dest.kind == 'v' && !isDeclaration(instruction) && firstAssigned[instruction.dest.index] == unassigned)
+                    {
+                        firstAssigned[instruction.dest.index] = position;
+                    }
+                    position++;
+                }
+            }
+
+            DataFlowResult result = definiteAssignment();
+            vector<IRBlock>& blocks = program.getBlocks();
+            set<pair<int, Node*>> reported;
+            position = 0;
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                BitVector current = result.in[b];
+                for (IRInstruction& instruction : blocks[b].instructions)
+                {
+                    for (const IRValue& read : {instruction.first, instruction.second})
+                    {
+                        bool afterAssignment = read.kind == 'v' && firstAssigned[read.index] != unassigned && firstAssigned[read.index] < position;
+                        if (afterAssignment && !current.test(read.index) && reported.insert({read.index, instruction.node}).second)
+                        {
+                            IRSymbol& symbol = program.getSymbols()[read.index];
+                            log("WARNING", symbol.type + " [" + symbol.name + "] is used at " + positionOf(instruction.node) + ", but isn't assigned on every path before it");
+                        }
+                    }
+                    if (instruction.dest.kind == 'v')
+                    {
+                        if (isDeclaration(instruction))
+                        {
+                            current.reset(instruction.dest.index);
+                        }
+                        else
+                        {
+                            current.set(instruction.dest.index);
+                        }
+                    }
+                    position++;
+                }
+            }
+            return reported.size();
+        }
+
+        // Replaces reads of a variable with a constant when every definition that reaches them copies that same constant (or string)
+        // A string declaration isn't a definition (it keeps the pointer it had), so a string also has to be assigned on every path
+        int propagateConstants()
+        {
+            DataFlowResult result = reachingDefinitions();
+            DataFlowResult assigned = definiteAssignment();
+            vector<IRBlock>& blocks = program.getBlocks();
+            int replaced = 0;
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                // Definitions in the block so far override the ones that reached its start
+                unordered_map<int, int> localDefinitions;
+                BitVector current = assigned.in[b];
+                for (int i = 0, m = blocks[b].instructions.size(); i < m; i++)
+                {
+                    IRInstruction& instruction = blocks[b].instructions[i];
+                    for (IRValue* read : {&instruction.first, &instruction.second})
+                    {
+                        if (read->kind != 'v')
+                        {
+                            continue;
+                        }
+                        if (program.getSymbols()[read->index].type == "string" && !current.test(read->index))
+                        {
+                            continue;
+                        }
+
+                        IRValue constant;
+                        auto local = localDefinitions.find(read->index);
+                        if (local != localDefinitions.end())
+                        {
+                            constant = copiedConstant(local->second);
+                        }
+                        else
+                        {
+                            constant = reachingConstant(result.in[b], read->index);
+                        }
+                        if (constant.kind != ' ')
+                        {
+                            *read = constant;
+                            replaced++;
+                        }
+                    }
+
+                    int dest = valueIndex(instruction.dest);
+                    if (dest >= 0)
+                    {
+                        localDefinitions[dest] = definitionIds[b][i];
+                    }
+                    if (instruction.dest.kind == 'v')
+                    {
+                        if (isDeclaration(instruction))
+                        {
+                            current.reset(instruction.dest.index);
+                        }
+                        else
+                        {
+                            current.set(instruction.dest.index);
+                        }
+                    }
+                }
+            }
+
+            // Copies that now copy a constant
+            numberDefinitions();
+            return replaced;
+        }
+
+        // Removes instructions that write a variable or temp nothing reads afterwards
+        int removeDeadStores()
+        {
+            DataFlowResult result = liveness();
+            vector<IRBlock>& blocks = program.getBlocks();
+            int removed = 0;
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                BitVector live = result.out[b];
+                vector<IRInstruction> kept;
+                for (int i = blocks[b].instructions.size() - 1; i >= 0; i--)
+                {
+                    IRInstruction& instruction = blocks[b].instructions[i];
+                    int dest = valueIndex(instruction.dest);
+                    if (dest >= 0 && !live.test(dest))
+                    {
+                        removed++;
+                        continue;
+                    }
+                    if (dest >= 0)
+                    {
+                        live.reset(dest);
+                    }
+                    for (const IRValue& read : {instruction.first, instruction.second})
+                    {
+                        if (valueIndex(read) >= 0)
+                        {
+                            live.set(valueIndex(read));
+                        }
+                    }
+                    kept.emplace_back(instruction);
+                }
+                reverse(kept.begin(), kept.end());
+                blocks[b].instructions = kept;
+            }
+
+            // Removed instructions change the definitions
+            numberDefinitions();
+            return removed;
+        }
+
+        // Logs what flows into and out of every block
+        void print(const int programNumber)
+        {
+            DataFlowResult live = liveness();
+            DataFlowResult reaching = reachingDefinitions();
+            DataFlowResult assigned = definiteAssignment();
+            log("INFO", "Data flow for Program #" + to_string(programNumber) + " (" + to_string(cfg.size()) + " block(s), " + to_string(definitionCount) + " definition(s))");
+            vector<IRBlock>& blocks = program.getBlocks();
+            for (int b = 0, n = blocks.size(); b < n; b++)
+            {
+                string successors = "";
+                for (int successor : cfg.getSuccessors(b))
+                {
+                    successors += " L" + to_string(blocks[successor].label);
+                }
+                if (successors.empty())
+                {
+                    successors = " nothing";
+                }
+                log("INFO", "L" + to_string(blocks[b].label) + ": goes to" + successors);
+                log("INFO", "    live in: " + describeValues(live.in[b], valueCount) + ", live out: " + describeValues(live.out[b], valueCount));
+                log("INFO", "    assigned in: " + describeValues(assigned.in[b], variableCount) + ", " + to_string(reaching.in[b].count()) + " definition(s) reach it");
+            }
+        }
+
+        // Getters
+        ControlFlowGraph& getCFG()
+        {
+            return this->cfg;
+        }
+
+        // Blocks visited by the last solve (at most a few times the number of blocks)
+        int getVisits()
+        {
+            return this->visits;
+        }
+
+    private:
+        // Default members
+        IRProgram& program;
+        ControlFlowGraph cfg;
+        int variableCount;
+        int valueCount;
+        int visits = 0;
+
+        // Id of every definition by block and instruction (-1 for instructions that don't write a value),
+        // what each definition copies, and the definitions of every value
+        int definitionCount = 0;
+        vector<vector<int>> definitionIds;
+        vector<IRInstruction> definitions;
+        vector<vector<int>> definitionsOf;
+
+        // Numbers every instruction that writes a variable or temp
+        void numberDefinitions()
+        {
+            definitionCount = 0;
+            definitionIds.clear();
+            definitions.clear();
+            definitionsOf.assign(valueCount, vector<int>());
+            for (IRBlock& block : program.getBlocks())
+            {
+                definitionIds.emplace_back();
+                for (IRInstruction& instruction : block.instructions)
+                {
+                    int dest = valueIndex(instruction.dest);
+                    if (dest >= 0)
+                    {
+                        definitionsOf[dest].emplace_back(definitionCount);
+                        definitions.emplace_back(instruction);
+                        definitionIds.back().emplace_back(definitionCount++);
+                    }
+                    else
+                    {
+                        definitionIds.back().emplace_back(-1);
+                    }
+                }
+            }
+        }
+
+        // Index of a variable or temp in the value sets (temps go after the variables), -1 for anything else
+        int valueIndex(const IRValue& value)
+        {
+            if (value.kind == 'v')
+            {
+                return value.index;
+            }
+            else if (value.kind == 't')
+            {
+                return variableCount + value.index;
+            }
+            return -1;
+        }
+
+        // What a definition copies if it copies a constant or string, none otherwise
+        IRValue copiedConstant(const int definition)
+        {
+            IRInstruction& instruction = definitions[definition];
+            if (instruction.op == "copy" && (instruction.first.kind == 'c' || instruction.first.kind == 's'))
+            {
+                return instruction.first;
+            }
+            return IRValue();
+        }
+
+        // The constant every reaching definition of a variable copies, none if they don't all copy the same one (or none reach)
+        IRValue reachingConstant(const BitVector& reaching, const int variable)
+        {
+            IRValue constant;
+            bool found = false;
+            for (int definition : definitionsOf[variable])
+            {
+                if (!reaching.test(definition))
+                {
+                    continue;
+                }
+                IRValue copied = copiedConstant(definition);
+                if (copied.kind == ' ' || (found && !(copied == constant)))
+                {
+                    return IRValue();
+                }
+                constant = copied;
+                found = true;
+            }
+            return constant;
+        }
+
+        // Whether or not an instruction is the 0 a declaration gives its variable
+        bool isDeclaration(const IRInstruction& instruction)
+        {
+            return instruction.node && instruction.node->getName() == "Declare";
+        }
+
+        // Line and column of the first token under a Node
+        string positionOf(Node* node)
+        {
+            Token* token = nullptr;
+            if (node)
+            {
+                token = node->getFirstToken();
+            }
+            if (!token)
+            {
+                return "(0:0)";
+            }
+            return "(" + to_string(token->getLine()) + ":" + to_string(token->getColumn()) + ")";
+        }
+
+        // Names of the values in a set
+        string describeValues(const BitVector& values, const int count)
+        {
+            string text = "";
+            for (int i = 0; i < count; i++)
+            {
+                if (!values.test(i))
+                {
+                    continue;
+                }
+                if (!text.empty())
+                {
+                    text += " ";
+                }
+                if (i < variableCount)
+                {
+                    text += program.describe(IRValue('v', i));
+                }
+                else
+                {
+                    text += program.describe(IRValue('t', i - variableCount));
+                }
+            }
+            if (text.empty())
+            {
+                return "-";
+            }
+            return text;
+        }
+
+        // Logging function for Data Flow
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Data Flow - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
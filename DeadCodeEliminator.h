@@ -0,0 +1,304 @@
+#ifndef DEADCODEELIMINATOR_H
+#define DEADCODEELIMINATOR_H
+
+using namespace std;
+
+// Removes assignments whose value is never read (liveness) and variables that are never read at all
+// Strings that were only assigned to removed variables never get created in the heap
+class DeadCodeEliminator
+{
+    public:
+        // Default constructor for the DeadCodeEliminator class
+        DeadCodeEliminator(const int progNum, Tree* progAST, SymbolTable* progSymTable)
+        {
+            this->programNumber = progNum;
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+        }
+
+        // Removes dead code until there is none left, returns how many statements were removed
+        int eliminate()
+        {
+            int storeCount = 0;
+            int variableCount = 0;
+
+            // Removing a store can make the values it read dead as well
+            bool changed = true;
+            while (changed)
+            {
+                resolve();
+                set<Variable> live;
+                int stores = liveBlock(myAST->getRoot(), live, true);
+
+                resolve();
+                int unused = removeUnusedVariables();
+
+                storeCount += stores;
+                variableCount += unused;
+                changed = stores + unused > 0;
+            }
+
+            log("DEBUG", "Dead Code: Removed " + to_string(storeCount) + " dead store(s) and " + to_string(variableCount) + " unused variable(s) in Program #" + to_string(programNumber));
+            return storeCount + variableCount;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Tree* myAST;
+        SymbolTable* mySymTable;
+
+        // A variable is its name and the scope it was declared in
+        typedef pair<HashNode*, string> Variable;
+
+        // Variable that every Declare, Assign, and identifier refers to
+        unordered_map<Node*, Variable> variables;
+
+        // Variables declared so far while resolving (a variable can't be read before its declaration, even if its scope already has it)
+        set<Variable> declared;
+
+        // Every declaration in program order, and every variable that gets read somewhere
+        vector<Node*> declarations;
+        set<Variable> read;
+
+        // Finds the variable that every Node in the program refers to
+        void resolve()
+        {
+            variables.clear();
+            declared.clear();
+            declarations.clear();
+            read.clear();
+            resolveBlock(myAST->getRoot(), mySymTable->getRoot());
+        }
+
+        // Finds the variable that every Node in a Block refers to (scope is the Symbol Table scope that belongs to the Block)
+        void resolveBlock(Node* block, HashNode* scope)
+        {
+            // Child scopes are in the same order as the Blocks inside this one
+            int scopeIndex = 0;
+
+            for (Node* statement : block->getChildren())
+            {
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    resolveBlock(statement, scope->getChild(scopeIndex));
+                    scopeIndex++;
+                }
+                else if (name == "Declare")
+                {
+                    Variable var = Variable(scope, statement->getChild(1)->getName());
+                    declared.insert(var);
+                    declarations.emplace_back(statement);
+                    variables[statement] = var;
+                }
+                else if (name == "Assign")
+                {
+                    resolveReads(statement->getChild(1), scope);
+                    variables[statement] = resolve(statement->getChild(0)->getName(), scope);
+                }
+                else if (name == "Print")
+                {
+                    resolveReads(statement->getChild(0), scope);
+                }
+                else if (name == "If" || name == "While")
+                {
+                    resolveReads(statement->getChild(0), scope);
+                    resolveBlock(statement->getChild(1), scope->getChild(scopeIndex));
+                    scopeIndex++;
+                }
+            }
+        }
+
+        // Finds the variable every identifier in an expression refers to
+        void resolveReads(Node* node, HashNode* scope)
+        {
+            if (!node->isLeaf())
+            {
+                for (Node* child : node->getChildren())
+                {
+                    resolveReads(child, scope);
+                }
+            }
+            else if (node->getToken()->getType() == "ID")
+            {
+                variables[node] = resolve(node->getName(), scope);
+                read.insert(variables[node]);
+            }
+        }
+
+        // Finds the variable a name refers to from a scope (the closest declaration that came before)
+        Variable resolve(const string varName, HashNode* scope)
+        {
+            HashNode* node = scope;
+            while (node && declared.find(Variable(node, varName)) == declared.end())
+            {
+                node = node->getParent();
+            }
+            return Variable(node, varName);
+        }
+
+        // Goes backwards through a Block, turning the variables live after it into the variables live before it
+        // Assignments to variables that aren't live are removed if remove is true, returns how many were removed
+        int liveBlock(Node* block, set<Variable>& live, const bool remove)
+        {
+            int removed = 0;
+
+            vector<Node*> statements = block->getChildren();
+            for (int i = statements.size() - 1; i >= 0; i--)
+            {
+                Node* statement = statements[i];
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    removed += liveBlock(statement, live, remove);
+                }
+                else if (name == "Declare")
+                {
+                    // Declaring an int or boolean sets it to 0, so its old value is never read (a string keeps its old pointer)
+                    if (statement->getChild(0)->getName() != "string")
+                    {
+                        live.erase(variables[statement]);
+                    }
+                }
+                else if (name == "Assign")
+                {
+                    Variable target = variables[statement];
+
+                    // The value is overwritten (or never read) before anything reads it
+                    if (remove && live.find(target) == live.end())
+                    {
+                        log("DEBUG", "Dead Code: Removing dead store to [" + target.second + "] at (" + location(statement->getChild(0)) + ")");
+                        block->removeChild(statement);
+                        deleteNode(statement);
+                        removed++;
+                        continue;
+                    }
+
+                    live.erase(target);
+                    addReads(statement->getChild(1), live);
+                }
+                else if (name == "Print")
+                {
+                    addReads(statement->getChild(0), live);
+                }
+                else if (name == "If")
+                {
+                    // The block might not run, so whatever is live after it is still live before it
+                    set<Variable> bodyLive = live;
+                    removed += liveBlock(statement->getChild(1), bodyLive, remove);
+                    live.insert(bodyLive.begin(), bodyLive.end());
+                    addReads(statement->getChild(0), live);
+                }
+                else if (name == "While")
+                {
+                    // The top of the loop is reached from before it and from the end of the block, so find what's live there until nothing changes
+                    set<Variable> top = live;
+                    addReads(statement->getChild(0), top);
+                    bool changed = true;
+                    while (changed)
+                    {
+                        set<Variable> bodyLive = top;
+                        liveBlock(statement->getChild(1), bodyLive, false);
+
+                        int sizeBefore = top.size();
+                        top.insert(bodyLive.begin(), bodyLive.end());
+                        changed = (int)top.size() != sizeBefore;
+                    }
+
+                    // The block leads back to the top of the loop
+                    if (remove)
+                    {
+                        set<Variable> bodyLive = top;
+                        removed += liveBlock(statement->getChild(1), bodyLive, true);
+                    }
+                    live = top;
+                }
+            }
+
+            return removed;
+        }
+
+        // Adds every variable read in an expression to the live set
+        void addReads(Node* node, set<Variable>& live)
+        {
+            if (!node->isLeaf())
+            {
+                for (Node* child : node->getChildren())
+                {
+                    addReads(child, live);
+                }
+            }
+            else if (node->getToken()->getType() == "ID")
+            {
+                live.insert(variables[node]);
+            }
+        }
+
+        // Removes the declarations of variables that are never read (their assignments were already removed as dead stores)
+        int removeUnusedVariables()
+        {
+            int removed = 0;
+            for (Node* statement : declarations)
+            {
+                Variable var = variables[statement];
+                if (read.find(var) == read.end())
+                {
+                    log("DEBUG", "Dead Code: Removing unused variable [" + var.second + "] declared at (" + location(statement->getChild(1)) + ")");
+                    statement->getParent()->removeChild(statement);
+                    deleteNode(statement);
+                    removed++;
+                }
+            }
+            return removed;
+        }
+
+        // Line and column of a Node's token
+        string location(Node* node)
+        {
+            Token* token = node->getToken();
+            return to_string(token->getLine()) + ":" + to_string(token->getColumn());
+        }
+
+        // Deletes a removed part of the AST
+        void deleteNode(Node* node)
+        {
+            for (Node* child : node->getChildren())
+            {
+                deleteNode(child);
+            }
+            delete(node);
+        }
+
+        // Logging function for the optimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Optimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,672 @@
+#ifndef DIFFHARNESS_H
+#define DIFFHARNESS_H
+
+using namespace std;
+
+// Compiles every program at -O0 and at other optimization settings, runs each build in the emulator, and compares it to -O0
+// Every variant has to print the same output and end the same way, and without dce (which drops stores nothing reads) leave every variable with the same value
+// The source of a mismatch is cut down to the fewest lines that still mismatch the same way
+class DiffHarness
+{
+    public:
+        // Default constructor for the DiffHarness class (the target, back end, budgets, and jobs come from the options)
+        DiffHarness(Options baseOptions, const char progDelimiter)
+        {
+            this->target = baseOptions.getTarget();
+            this->base = baseOptions;
+            base.setIR(baseOptions.usesIR());
+            base.setDumpIR(false);
+            base.setRun(false);
+            base.setListing(false);
+            base.setProfilePath("");
+            base.setSourceMapPath("");
+            base.clearPasses();
+            this->jobs = baseOptions.getJobs();
+            this->stepBudget = baseOptions.getStepBudget();
+            this->cycleBudget = baseOptions.getCycleBudget();
+            this->delimiter = progDelimiter;
+
+            // Every level, then every pass on its own over -O0 and left out of -O2
+            reference = Variant("-O0", "0", "", false);
+            variants.emplace_back("-O1", "1", "", false);
+            variants.emplace_back("-O2", "2", "", false);
+            variants.emplace_back("-Os", "s", "", false);
+            for (const string& pass : Options::passNames())
+            {
+                variants.emplace_back("-O0 --enable=" + pass, "0", pass, true);
+            }
+            for (const string& pass : Options::passNames())
+            {
+                variants.emplace_back("-O2 --disable=" + pass, "2", pass, false);
+            }
+        }
+
+        // Adds a program to compare
+        void add(const string file, const int progNum, const string source)
+        {
+            programs.emplace_back(file, progNum, source);
+        }
+
+        // Compiles and runs every program at every variant, then compares each one to -O0
+        void run()
+        {
+            auto start = chrono::steady_clock::now();
+
+            // Compiler output is only noise here, so it's thrown away until the results are in
+            streambuf* console = cout.rdbuf(nullptr);
+
+            // Everything is compiled first, since the compiler only runs on one thread
+            vector<Variant> settings = {reference};
+            settings.insert(settings.end(), variants.begin(), variants.end());
+
+            vector<Result*> builds;
+            for (Program& program : programs)
+            {
+                vector<Result> results = buildEach(program.source, program.number, settings);
+                program.reference = results[0];
+                program.results.assign(results.begin() + 1, results.end());
+
+                builds.emplace_back(&program.reference);
+                for (Result& result : program.results)
+                {
+                    builds.emplace_back(&result);
+                }
+            }
+
+            // Each worker only writes to the builds it took
+            workersUsed = BatchRunner::runOnWorkers(jobs, builds.size(), [this, &builds](const int index)
+            {
+                execute(*builds[index]);
+            });
+
+            // Compare, then cut down the source of every mismatch
+            for (Program& program : programs)
+            {
+                if (program.reference.status != "compiled")
+                {
+                    continue;
+                }
+                for (int i = 0, n = variants.size(); i < n; i++)
+                {
+                    Result& result = program.results[i];
+                    if (result.status == "memory error")
+                    {
+                        result.skipped = true;
+                        continue;
+                    }
+                    result.mismatch = compare(program.reference, result);
+                    if (result.mismatch != "")
+                    {
+                        result.minimized = minimize(program, variants[i], result.mismatch);
+                    }
+                }
+            }
+
+            cout.rdbuf(console);
+            cout.clear();
+
+            auto end = chrono::steady_clock::now();
+            milliseconds = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        }
+
+        // Logs the size and cycle deltas of every variant, then every mismatch with its cut down source
+        void printSummary()
+        {
+            int compared = 0;
+            for (Program& program : programs)
+            {
+                if (program.reference.status == "compiled")
+                {
+                    compared++;
+                }
+            }
+            log("INFO", "Compared " + to_string(compared) + " of " + to_string(programs.size()) + " program(s) (the rest didn't compile at -O0) at " + to_string(variants.size()) + " variant(s) on " + to_string(workersUsed) + " worker(s) in " + to_string(milliseconds) + " ms");
+            log("INFO", column("VARIANT", 28) + column("MISMATCHES", 12) + column("SKIPPED", 10) + column("BYTES", 10) + "CYCLES");
+
+            int mismatchCount = 0;
+            int skippedCount = 0;
+            for (int i = 0, n = variants.size(); i < n; i++)
+            {
+                int mismatches = 0;
+                int skipped = 0;
+                long long bytes = 0;
+                long long cycles = 0;
+                for (Program& program : programs)
+                {
+                    if (program.reference.status != "compiled")
+                    {
+                        continue;
+                    }
+                    Result& result = program.results[i];
+                    if (result.mismatch != "")
+                    {
+                        mismatches++;
+                    }
+                    if (result.skipped)
+                    {
+                        skipped++;
+                    }
+                    bytes += bytesDelta(program.reference, result);
+                    cycles += cyclesDelta(program.reference, result);
+                }
+                mismatchCount += mismatches;
+                skippedCount += skipped;
+                log("INFO", column(variants[i].name, 28) + column(to_string(mismatches), 12) + column(to_string(skipped), 10) + column(signedValue(bytes), 10) + signedValue(cycles));
+            }
+
+            // Builds that don't fit anywhere have nothing to compare, so they don't count as mismatches
+            for (Program& program : programs)
+            {
+                for (int i = 0, n = program.results.size(); i < n; i++)
+                {
+                    if (program.results[i].skipped)
+                    {
+                        log("WARNING", program.file + " Program #" + to_string(program.number) + " at " + variants[i].name + " - skipped, doesn't fit in memory at any level");
+                    }
+                }
+            }
+
+            // Mismatches with the source they were cut down to
+            for (Program& program : programs)
+            {
+                for (int i = 0, n = program.results.size(); i < n; i++)
+                {
+                    Result& result = program.results[i];
+                    if (result.mismatch == "")
+                    {
+                        continue;
+                    }
+
+                    // Source that was cut down
+                    log("ERROR", program.file + " Program #" + to_string(program.number) + " at " + variants[i].name + " - " + result.mismatch);
+                    stringstream lines(result.minimized);
+                    string line;
+                    while (getline(lines, line))
+                    {
+                        log("ERROR", "    " + line);
+                    }
+                }
+            }
+
+            if (mismatchCount == 0)
+            {
+                log("INFO", "Every variant matched -O0 (" + to_string(skippedCount) + " build(s) skipped)");
+            }
+            else
+            {
+                log("ERROR", to_string(mismatchCount) + " mismatch(es) with -O0");
+            }
+        }
+
+        // Writes the result of every variant of every program that compiled at -O0 as a JSON array, returns false if it couldn't be written
+        bool writeReport(const string path)
+        {
+            ofstream file(path);
+            if (!file)
+            {
+                log("ERROR", "Could not write the diff report to " + path);
+                return false;
+            }
+
+            file << "[" << endl;
+            bool first = true;
+            for (Program& program : programs)
+            {
+                if (program.reference.status != "compiled")
+                {
+                    continue;
+                }
+                for (int i = 0, n = variants.size(); i < n; i++)
+                {
+                    Result& result = program.results[i];
+                    if (!first)
+                    {
+                        file << "," << endl;
+                    }
+                    first = false;
+
+                    file << "  {\"file\": " << BatchRunner::quote(program.file)
+                         << ", \"program\": " << program.number
+                         << ", \"variant\": " << BatchRunner::quote(variants[i].name)
+                         << ", \"level\": " << BatchRunner::quote(result.build.level)
+                         << ", \"exit\": " << BatchRunner::quote(result.exitReason)
+                         << ", \"bytes\": " << bytesOf(result)
+                         << ", \"bytesDelta\": " << bytesDelta(program.reference, result)
+                         << ", \"cycles\": " << result.cycles
+                         << ", \"cyclesDelta\": " << cyclesDelta(program.reference, result)
+                         << ", \"skipped\": " << boolalpha << result.skipped << noboolalpha
+                         << ", \"mismatch\": " << BatchRunner::quote(result.mismatch)
+                         << ", \"minimized\": " << BatchRunner::quote(result.minimized) << "}";
+                }
+            }
+            file << endl << "]" << endl;
+
+            log("INFO", "Diff report written to " + path);
+            return true;
+        }
+
+        // Returns whether or not every variant matched -O0
+        bool matched()
+        {
+            for (Program& program : programs)
+            {
+                for (Result& result : program.results)
+                {
+                    if (result.mismatch != "")
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        // Default members
+        Target target;
+        int jobs;
+
+        // Options every variant starts from (the target, --ir, and --cost, with nothing that prints or writes a file, and no passes
+        // turned on or off by themselves)
+        Options base;
+        long long stepBudget;
+        long long cycleBudget;
+        char delimiter;
+
+        // Most programs a mismatch compiles and runs while its source is cut down
+        static const int MAX_TESTS = 200;
+
+        // An optimization setting (a level, with a single pass turned on or off if there is one)
+        struct Variant
+        {
+            string name;
+            string level;
+            string pass;
+            bool enabled;
+
+            // Constructor for struct
+            Variant(const string n = "", const string l = "0", const string p = "", const bool e = false)
+            {
+                name = n;
+                level = l;
+                pass = p;
+                enabled = e;
+            }
+        };
+
+        // A program built and run at a single variant
+        struct Result
+        {
+            string status;
+            Build build;
+            bool comparesVariables = false;
+
+            // Whether or not it was left out because it doesn't fit in memory at any level
+            bool skipped = false;
+            string exitReason;
+            string output;
+            long long cycles = 0;
+
+            // Final value of every variable (name@scope), with strings read from the heap
+            map<string, string> variables;
+
+            string mismatch;
+            string minimized;
+        };
+
+        // A program from the corpus and its results at -O0 and at every variant
+        struct Program
+        {
+            string file;
+            int number;
+            string source;
+            Result reference;
+            vector<Result> results;
+
+            // Constructor for struct
+            Program(const string f, const int n, const string s)
+            {
+                file = f;
+                number = n;
+                source = s;
+            }
+        };
+
+        Variant reference;
+        vector<Variant> variants;
+        vector<Program> programs;
+
+        // Timing of the last run
+        long long milliseconds = 0;
+        int workersUsed = 0;
+
+        // Compiles a program at each variant (the front end only runs once)
+        vector<Result> buildEach(const string source, const int progNum, const vector<Variant>& settings)
+        {
+            vector<Options> optionSets;
+            for (const Variant& variant : settings)
+            {
+                Options options = base;
+                options.setLevel(variant.level);
+                if (variant.pass != "")
+                {
+                    options.setPass(variant.pass, variant.enabled);
+                }
+                optionSets.emplace_back(options);
+            }
+
+            Compiler compiler = Compiler(progNum, source, delimiter, optionSets[0]);
+            vector<string> statuses = compiler.compileEach(optionSets);
+            vector<Build> builds = compiler.getBuilds();
+
+            vector<Result> results(settings.size());
+            for (int i = 0, n = settings.size(); i < n; i++)
+            {
+                results[i].status = statuses[i];
+                results[i].build = builds[i];
+
+                // Removing stores nothing reads changes what is left in memory, but not what is printed
+                // (the size ladder can keep a level with dce on, even for -O0)
+                Options kept = optionSets[i];
+                if (builds[i].level != "")
+                {
+                    kept.setLevel(builds[i].level);
+                }
+                results[i].comparesVariables = !kept.isEnabled("dce");
+            }
+            return results;
+        }
+
+        // Runs a build in its own emulator, keeping what it printed and the final value of every variable
+        void execute(Result& result)
+        {
+            if (result.status != "compiled")
+            {
+                return;
+            }
+
+            Emulator emulator = Emulator(result.build.image);
+            emulator.setBudget(stepBudget, cycleBudget);
+            emulator.run();
+
+            result.exitReason = emulator.getExitReason();
+            result.output = emulator.getOutput();
+            result.cycles = emulator.getCycles();
+
+            vector<int> memory = emulator.getMemory();
+            Build& placed = result.build;
+            for (int i = 0, n = placed.staticNames.size(); i < n; i++)
+            {
+                // Temporary values have no data type
+                string type = placed.staticTypes[i];
+                if (type == "")
+                {
+                    continue;
+                }
+
+                int value = memory[placed.codeSize + i];
+                if (type == "string")
+                {
+                    result.variables[placed.staticNames[i]] = readString(memory, value);
+                }
+                else
+                {
+                    result.variables[placed.staticNames[i]] = to_string(value);
+                }
+            }
+
+            // The image isn't needed anymore
+            placed.image.clear();
+        }
+
+        // Compares a variant to -O0, returns what differs ("" if nothing does), starting with the kind of mismatch
+        string compare(Result& expected, Result& actual)
+        {
+            // Builds that don't fit in memory at any level are skipped before this, since there is nothing to run
+            if (actual.status != "compiled")
+            {
+                return "compile: " + actual.status;
+            }
+
+            // A run that hit its budget could have printed more, so it only has to have printed the start of the other one
+            bool expectedStopped = isBudget(expected.exitReason);
+            bool actualStopped = isBudget(actual.exitReason);
+            if (expectedStopped || actualStopped)
+            {
+                bool matches;
+                if (expectedStopped && actualStopped)
+                {
+                    matches = startsWith(expected.output, actual.output) || startsWith(actual.output, expected.output);
+                }
+                else if (expectedStopped)
+                {
+                    matches = startsWith(actual.output, expected.output);
+                }
+                else
+                {
+                    matches = startsWith(expected.output, actual.output);
+                }
+
+                if (!matches)
+                {
+                    return "output: \"" + clip(actual.output) + "\" instead of \"" + clip(expected.output) + "\"";
+                }
+                return "";
+            }
+
+            if (actual.exitReason != expected.exitReason)
+            {
+                return "exit: " + actual.exitReason + " instead of " + expected.exitReason;
+            }
+            if (actual.output != expected.output)
+            {
+                return "output: \"" + clip(actual.output) + "\" instead of \"" + clip(expected.output) + "\"";
+            }
+
+            // Variables that are in both builds end with the same value (unless dce was on for either one)
+            if (expected.comparesVariables && actual.comparesVariables && actual.exitReason == "break")
+            {
+                for (const auto& entry : expected.variables)
+                {
+                    auto found = actual.variables.find(entry.first);
+                    if (found != actual.variables.end() && found->second != entry.second)
+                    {
+                        return "memory: " + entry.first + " is " + found->second + " instead of " + entry.second;
+                    }
+                }
+            }
+            return "";
+        }
+
+        // Cuts the source of a mismatch down by taking out runs of lines (half of them, then quarters, and so on)
+        // A smaller source is kept if it still compiles at -O0 and mismatches the same way
+        string minimize(Program& program, Variant& variant, const string mismatch)
+        {
+            string kind = mismatch.substr(0, mismatch.find(':'));
+            vector<string> lines;
+            stringstream sourceLines(program.source);
+            string line;
+            while (getline(sourceLines, line))
+            {
+                lines.emplace_back(line);
+            }
+
+            int tests = 0;
+            int chunks = 2;
+            while (lines.size() >= 2 && tests < MAX_TESTS)
+            {
+                int size = lines.size();
+                int chunkSize = (size + chunks - 1) / chunks;
+                bool reduced = false;
+
+                for (int start = 0; start < size && tests < MAX_TESTS; start += chunkSize)
+                {
+                    vector<string> candidate(lines.begin(), lines.begin() + start);
+                    candidate.insert(candidate.end(), lines.begin() + min(size, start + chunkSize), lines.end());
+                    tests++;
+
+                    if (mismatchesAs(join(candidate), program.number, variant, kind))
+                    {
+                        lines = candidate;
+                        chunks = max(chunks - 1, 2);
+                        reduced = true;
+                        break;
+                    }
+                }
+
+                if (!reduced)
+                {
+                    if (chunks >= size)
+                    {
+                        break;
+                    }
+                    chunks = min(size, chunks * 2);
+                }
+            }
+            return join(lines);
+        }
+
+        // Returns whether or not a source compiles at -O0 and mismatches at a variant with the same kind of mismatch
+        bool mismatchesAs(const string source, const int progNum, Variant& variant, const string kind)
+        {
+            vector<Result> results = buildEach(source, progNum, {reference, variant});
+            Result& expected = results[0];
+            Result& actual = results[1];
+            if (expected.status != "compiled")
+            {
+                return false;
+            }
+            execute(expected);
+            execute(actual);
+
+            string mismatch = compare(expected, actual);
+            return mismatch != "" && mismatch.substr(0, mismatch.find(':')) == kind;
+        }
+
+        // Reads a string variable from the heap (a pointer of 0x00 is a string that was never assigned)
+        string readString(vector<int>& memory, const int pointer)
+        {
+            if (pointer == 0x00)
+            {
+                return "(unassigned)";
+            }
+
+            string str = "\"";
+            for (int address = target.getHeapStart() + pointer; address < (int)memory.size() && memory[address] != 0x00; address++)
+            {
+                str += (char)memory[address];
+            }
+            return str + "\"";
+        }
+
+        // Returns whether or not a run was stopped by its budget
+        bool isBudget(const string exitReason)
+        {
+            return exitReason == "step budget" || exitReason == "cycle budget";
+        }
+
+        // Returns whether or not a string starts with another one
+        bool startsWith(const string& str, const string& start)
+        {
+            return str.compare(0, start.length(), start) == 0;
+        }
+
+        // Bytes a build takes up in memory
+        int bytesOf(Result& result)
+        {
+            return result.build.codeSize + result.build.staticSize + result.build.heapSize;
+        }
+
+        // Bytes a variant saved or added over -O0 (0 if it didn't compile)
+        long long bytesDelta(Result& expected, Result& actual)
+        {
+            if (actual.status != "compiled")
+            {
+                return 0;
+            }
+            return bytesOf(actual) - bytesOf(expected);
+        }
+
+        // Cycles a variant saved or added over -O0 (only when both runs ended with a break)
+        long long cyclesDelta(Result& expected, Result& actual)
+        {
+            if (expected.exitReason != "break" || actual.exitReason != "break")
+            {
+                return 0;
+            }
+            return actual.cycles - expected.cycles;
+        }
+
+        // Joins lines back into a source
+        string join(const vector<string>& lines)
+        {
+            string source = "";
+            for (const string& line : lines)
+            {
+                source += line + "\n";
+            }
+            return source;
+        }
+
+        // Shortens output for a message
+        string clip(const string output)
+        {
+            const int maxLength = 40;
+            if ((int)output.length() <= maxLength)
+            {
+                return output;
+            }
+            return output.substr(0, maxLength) + "...";
+        }
+
+        // Shows the sign of a delta
+        string signedValue(const long long value)
+        {
+            if (value > 0)
+            {
+                return "+" + to_string(value);
+            }
+            return to_string(value);
+        }
+
+        // Pads a value to a column width
+        string column(const string value, const int width)
+        {
+            string padded = value;
+            while ((int)padded.length() < width)
+            {
+                padded += " ";
+            }
+            return padded;
+        }
+
+        // Logging function for the diff harness
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Diff - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,345 @@
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+using namespace std;
+
+// Runs a runtime environment made by Code Gen on the 6502 instruction subset it targets, counting cycles as it goes
+// Like the OS the code is written for, only CPX sets the zero flag and ADC doesn't use a carry
+class Emulator
+{
+    public:
+        // Constructor for an image straight from Code Gen (or read back from its hex dump)
+        Emulator(const vector<string> image)
+        {
+            for (const string& hex : image)
+            {
+                this->memory.emplace_back(stoi(hex, nullptr, 16));
+            }
+            this->addressCycles.assign(memory.size(), 0);
+            this->addressCounts.assign(memory.size(), 0);
+
+            // Cycles for every op code, looked up by the op code byte while running
+            this->cycleTable.fill(0);
+            for (const auto& entry : OP_CODES)
+            {
+                this->cycleTable[stoi(entry.first, nullptr, 16)] = entry.second.cycles;
+            }
+        }
+
+        // Caps how long a run can take (a step budget of 0 keeps the default, and a cycle budget of 0 means cycles aren't capped)
+        void setBudget(const long long maxSteps, const long long maxCycles)
+        {
+            if (maxSteps > 0)
+            {
+                this->stepBudget = maxSteps;
+            }
+            this->cycleBudget = maxCycles;
+        }
+
+        // Runs until a break, returns false if the program stopped any other way
+        bool run()
+        {
+            const int size = memory.size();
+            int pc = 0x00;
+            int a = 0x00;
+            int x = 0x00;
+            int y = 0x00;
+            bool zero = false;
+
+            for (steps = 0; steps < stepBudget; steps++)
+            {
+                int opCode = memory[pc];
+                int address = pc;
+                long long before = cycles;
+                cycles += cycleTable[opCode];
+
+                switch (opCode)
+                {
+                    // LDA (immediate, absolute)
+                    case 0xA9:
+                        a = readByte(pc + 1);
+                        pc += 2;
+                        break;
+                    case 0xAD:
+                        a = memory[readAddress(pc + 1)];
+                        pc += 3;
+                        break;
+
+                    // STA
+                    case 0x8D:
+                        memory[readAddress(pc + 1)] = a;
+                        pc += 3;
+                        break;
+
+                    // ADC
+                    case 0x6D:
+                        a = (a + memory[readAddress(pc + 1)]) & 0xFF;
+                        pc += 3;
+                        break;
+
+                    // LDX (immediate, absolute)
+                    case 0xA2:
+                        x = readByte(pc + 1);
+                        pc += 2;
+                        break;
+                    case 0xAE:
+                        x = memory[readAddress(pc + 1)];
+                        pc += 3;
+                        break;
+
+                    // LDY (immediate, absolute)
+                    case 0xA0:
+                        y = readByte(pc + 1);
+                        pc += 2;
+                        break;
+                    case 0xAC:
+                        y = memory[readAddress(pc + 1)];
+                        pc += 3;
+                        break;
+
+                    // NOP
+                    case 0xEA:
+                        pc += 1;
+                        break;
+
+                    // BRK ends the program
+                    case 0x00:
+                        addressCycles[address] += cycles - before;
+                        addressCounts[address]++;
+                        steps++;
+                        exitReason = "break";
+                        return true;
+
+                    // CPX
+                    case 0xEC:
+                        zero = x == memory[readAddress(pc + 1)];
+                        pc += 3;
+                        break;
+
+                    // BNE (a taken branch takes 1 more cycle, and 1 more than that if it lands in another page)
+                    case 0xD0:
+                    {
+                        int offset = (int8_t)readByte(pc + 1);
+                        pc += 2;
+                        if (!zero)
+                        {
+                            int destination = (pc + offset + size) % size;
+                            cycles++;
+                            if ((destination & 0xFF00) != (pc & 0xFF00))
+                            {
+                                cycles++;
+                            }
+                            pc = destination;
+                        }
+                        break;
+                    }
+
+                    // INC
+                    case 0xEE:
+                    {
+                        int address = readAddress(pc + 1);
+                        memory[address] = (memory[address] + 1) & 0xFF;
+                        pc += 3;
+                        break;
+                    }
+
+                    // System call: print the integer in Y ($01), the string Y points to ($02), or the string the operand points to ($03)
+                    case 0xFF:
+                        if (x == 0x01)
+                        {
+                            output += to_string(y);
+                            pc += 1;
+                        }
+                        else if (x == 0x02)
+                        {
+                            printString(y);
+                            pc += 1;
+                        }
+                        else if (x == 0x03)
+                        {
+                            printString(readAddress(pc + 1));
+                            pc += 3;
+                        }
+                        else
+                        {
+                            errorMessage = "Invalid system call with [" + toHex(x) + "] in the X register at [" + toAddress(pc) + "]";
+                            exitReason = "invalid system call";
+                            return false;
+                        }
+                        break;
+
+                    default:
+                        errorMessage = "Invalid op code [" + toHex(opCode) + "] at [" + toAddress(pc) + "]";
+                        exitReason = "invalid op code";
+                        return false;
+                }
+
+                // Running off the end of memory wraps around to the start
+                pc %= size;
+
+                addressCycles[address] += cycles - before;
+                addressCounts[address]++;
+
+                if (cycleBudget > 0 && cycles >= cycleBudget)
+                {
+                    steps++;
+                    errorMessage = "Stopped after " + to_string(cycles) + " cycle(s) without a break";
+                    exitReason = "cycle budget";
+                    return false;
+                }
+            }
+
+            errorMessage = "Stopped after " + to_string(stepBudget) + " instructions without a break";
+            exitReason = "step budget";
+            return false;
+        }
+
+        // Logs what the program printed and how long it took
+        void printResults(const int programNumber, const bool finished)
+        {
+            log("INFO", "Output of Program #" + to_string(programNumber) + ": " + output);
+            if (finished)
+            {
+                log("INFO", "Program #" + to_string(programNumber) + " finished after " + to_string(steps) + " instruction(s) and " + to_string(cycles) + " cycle(s)");
+            }
+            else
+            {
+                log("ERROR", errorMessage);
+            }
+        }
+
+        // Getters for the results of a run
+        string getOutput()
+        {
+            return this->output;
+        }
+
+        long long getCycles()
+        {
+            return this->cycles;
+        }
+
+        long long getSteps()
+        {
+            return this->steps;
+        }
+
+        string getErrorMessage()
+        {
+            return this->errorMessage;
+        }
+
+        // Why the run ended (break, step budget, cycle budget, invalid op code, or invalid system call)
+        string getExitReason()
+        {
+            return this->exitReason;
+        }
+
+        // Getter for memory as the run left it
+        vector<int> getMemory()
+        {
+            return this->memory;
+        }
+
+        // Cycles spent on (and times through) the instruction at each address
+        vector<long long> getAddressCycles()
+        {
+            return this->addressCycles;
+        }
+
+        vector<long long> getAddressCounts()
+        {
+            return this->addressCounts;
+        }
+
+    private:
+        // Memory of the runtime environment
+        vector<int> memory;
+
+        // Cycles for each op code byte
+        array<int, 0x100> cycleTable;
+
+        // Most instructions a program can run by default (so an infinite loop still ends)
+        static const long long MAX_STEPS = 1000000;
+
+        // Most instructions and cycles this run can take
+        long long stepBudget = MAX_STEPS;
+        long long cycleBudget = 0;
+
+        // Results of a run
+        string output;
+        long long cycles = 0;
+        long long steps = 0;
+        string errorMessage;
+        string exitReason;
+        vector<long long> addressCycles;
+        vector<long long> addressCounts;
+
+        // Reads a byte from memory (operands past the end wrap around to the start)
+        int readByte(const int index)
+        {
+            return memory[index % memory.size()];
+        }
+
+        // Reads a little endian address from memory
+        int readAddress(const int index)
+        {
+            return (readByte(index) | (readByte(index + 1) << 8)) % memory.size();
+        }
+
+        // Prints the characters of a string until its 0x00
+        void printString(int address)
+        {
+            while (address < (int)memory.size() && memory[address] != 0x00)
+            {
+                output += (char)memory[address];
+                address++;
+            }
+        }
+
+        // Convert decimal to hexadecimal
+        string toHex(int num)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(2) << setfill('0') << num;
+            return result.str();
+        }
+
+        // Convert an address to 4 digit hexadecimal
+        string toAddress(int address)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(4) << setfill('0') << address;
+            return result.str();
+        }
+
+        // Logging function for the emulator
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Emulator - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -80,6 +80,12 @@ class HashNode
             this->children.emplace_back(childNode);
         }
 
+        // Removes a child from the children vector (doesn't delete it)
+        void removeChild(HashNode* childNode)
+        {
+            this->children.erase(remove(this->children.begin(), this->children.end(), childNode), this->children.end());
+        }
+
         // Getter for line number
         int getLine(string name)
         {
@@ -226,6 +232,12 @@ class HashNode
             this->traversed = true;
         }
 
+        // Clear traversed when Code Gen starts over
+        void resetTraversed()
+        {
+            this->traversed = false;
+        }
+
     private:
         // Creates a struct that stores object information for each value in hash table
         struct hashObject
@@ -0,0 +1,304 @@
+#ifndef IR_H
+#define IR_H
+
+using namespace std;
+
+// Operand of an IR instruction
+struct IRValue
+{
+    // 'c' for a constant, 'v' for a variable (index into the symbols), 't' for a virtual temp, 's' for a pooled string, or ' ' for none
+    char kind;
+    int index;
+
+    // Constructor for struct
+    IRValue(const char k = ' ', const int i = 0)
+    {
+        kind = k;
+        index = i;
+    }
+
+    // Whether or not the value lives in memory (variables and temps), so it can be the operand of ADC, CPX, or STA
+    bool inMemory() const
+    {
+        return kind == 'v' || kind == 't';
+    }
+
+    bool operator==(const IRValue& other) const
+    {
+        return kind == other.kind && index == other.index;
+    }
+};
+
+// A variable from the Symbol Table (scope is the name of the scope it was declared in)
+struct IRSymbol
+{
+    string name;
+    string scope;
+    string type;
+
+    // Constructor for struct
+    IRSymbol(const string n, const string s, const string t)
+    {
+        name = n;
+        scope = s;
+        type = t;
+    }
+};
+
+// A three-address instruction:
+//   copy dest, first           add dest, first, second      eq/ne dest, first, second (1 if they are equal/different, 0 if not)
+//   print first (int/boolean)  prints first (string)
+//   bne/beq first, second, label (branch if they are different/equal)    jump label
+struct IRInstruction
+{
+    string op;
+    IRValue dest;
+    IRValue first;
+    IRValue second;
+    int label;
+
+    // AST Node the instruction was lowered from
+    Node* node;
+
+    // Constructor for struct
+    IRInstruction(const string o, const IRValue d, const IRValue f, const IRValue s, const int l, Node* n)
+    {
+        op = o;
+        dest = d;
+        first = f;
+        second = s;
+        label = l;
+        node = n;
+    }
+
+    // Whether or not the instruction ends a basic block
+    bool isBranch() const
+    {
+        return op == "bne" || op == "beq" || op == "jump";
+    }
+};
+
+// A basic block: a label, then instructions that run one after the other
+// Only the last instruction can branch, and a block that doesn't end with a jump falls into the next one
+struct IRBlock
+{
+    int label;
+    vector<IRInstruction> instructions;
+
+    // Constructor for struct
+    IRBlock(const int l)
+    {
+        label = l;
+    }
+};
+
+// A program lowered from the AST: its variables, strings, virtual temps, and basic blocks in the order they are laid out
+class IRProgram
+{
+    public:
+        // Default constructor for the IRProgram class
+        IRProgram()
+        {
+        }
+
+        // Adds a variable, returns its value
+        IRValue addSymbol(const string name, const string scope, const string type)
+        {
+            symbols.emplace_back(name, scope, type);
+            return IRValue('v', symbols.size() - 1);
+        }
+
+        // Creates a new virtual temp
+        IRValue newTemp()
+        {
+            return IRValue('t', tempCount++);
+        }
+
+        // Adds a string to the pool (the same string is only in it once), returns its value
+        IRValue addString(const string str)
+        {
+            auto found = find(strings.begin(), strings.end(), str);
+            if (found == strings.end())
+            {
+                strings.emplace_back(str);
+                found = strings.end() - 1;
+            }
+            return IRValue('s', found - strings.begin());
+        }
+
+        // Creates a label for a block that is started later
+        int newLabel()
+        {
+            return labelCount++;
+        }
+
+        // Starts a new block at a label (the block before it falls into it unless it ends with a jump)
+        void startBlock(const int label)
+        {
+            blocks.emplace_back(label);
+        }
+
+        // Adds an instruction to the end of the current block (a block that ended with a branch is followed by a new one)
+        void add(const IRInstruction instruction)
+        {
+            if (!blocks.back().instructions.empty() && blocks.back().instructions.back().isBranch())
+            {
+                startBlock(newLabel());
+            }
+            blocks.back().instructions.emplace_back(instruction);
+        }
+
+        // Getters
+        vector<IRSymbol>& getSymbols()
+        {
+            return this->symbols;
+        }
+
+        vector<string>& getStrings()
+        {
+            return this->strings;
+        }
+
+        vector<IRBlock>& getBlocks()
+        {
+            return this->blocks;
+        }
+
+        int getTempCount()
+        {
+            return this->tempCount;
+        }
+
+        int getLabelCount()
+        {
+            return this->labelCount;
+        }
+
+        // Number of instructions in every block
+        int size()
+        {
+            int total = 0;
+            for (IRBlock& block : blocks)
+            {
+                total += block.instructions.size();
+            }
+            return total;
+        }
+
+        // Logs every block and its instructions
+        void print(const int programNumber)
+        {
+            log("INFO", "IR for Program #" + to_string(programNumber) + " (" + to_string(symbols.size()) + " variable(s), " + to_string(tempCount) + " temp(s), " + to_string(blocks.size()) + " block(s))");
+            for (IRBlock& block : blocks)
+            {
+                log("INFO", "L" + to_string(block.label) + ":");
+                for (IRInstruction& instruction : block.instructions)
+                {
+                    log("INFO", "    " + describe(instruction));
+                }
+            }
+        }
+
+        // Text of an instruction (like t0 = 3 + a@0, or if a@0 != 5 goto L1)
+        string describe(const IRInstruction& instruction)
+        {
+            string op = instruction.op;
+            string first = describe(instruction.first);
+            string second = describe(instruction.second);
+            string label = "L" + to_string(instruction.label);
+
+            if (op == "copy")
+            {
+                return describe(instruction.dest) + " = " + first;
+            }
+            else if (op == "add")
+            {
+                return describe(instruction.dest) + " = " + first + " + " + second;
+            }
+            else if (op == "eq")
+            {
+                return describe(instruction.dest) + " = " + first + " == " + second;
+            }
+            else if (op == "ne")
+            {
+                return describe(instruction.dest) + " = " + first + " != " + second;
+            }
+            else if (op == "print")
+            {
+                return "print " + first;
+            }
+            else if (op == "prints")
+            {
+                return "print string " + first;
+            }
+            else if (op == "bne")
+            {
+                return "if " + first + " != " + second + " goto " + label;
+            }
+            else if (op == "beq")
+            {
+                return "if " + first + " == " + second + " goto " + label;
+            }
+            return "goto " + label;
+        }
+
+        // Text of a value (constants in decimal, variables with their scope, temps, and quoted strings)
+        string describe(const IRValue& value)
+        {
+            if (value.kind == 'c')
+            {
+                return to_string(value.index);
+            }
+            else if (value.kind == 'v')
+            {
+                return symbols[value.index].name + "@" + symbols[value.index].scope;
+            }
+            else if (value.kind == 't')
+            {
+                return "t" + to_string(value.index);
+            }
+            else if (value.kind == 's')
+            {
+                return "\"" + strings[value.index] + "\"";
+            }
+            return "";
+        }
+
+    private:
+        // Default members
+        vector<IRSymbol> symbols;
+        vector<string> strings;
+        vector<IRBlock> blocks;
+        int tempCount = 0;
+        int labelCount = 0;
+
+        // Logging function for the IR
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "IR - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,270 @@
+#ifndef IRBUILDER_H
+#define IRBUILDER_H
+
+using namespace std;
+
+// Lowers the AST to three-address IR
+// Variables are resolved to the symbol they refer to in the Symbol Table, every expression gets a virtual temp,
+// and If/While statements become basic blocks that end in explicit branches
+class IRBuilder
+{
+    public:
+        // Default constructor for the IRBuilder class
+        IRBuilder(Tree* progAST, SymbolTable* progSymTable)
+        {
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+        }
+
+        // Lowers the whole program
+        IRProgram lower()
+        {
+            program = IRProgram();
+            program.startBlock(program.newLabel());
+
+            // Scopes get marked as traversed while lowering
+            currentHash = mySymTable->getRoot();
+            resetTraversed(currentHash);
+
+            lowerStatement(myAST->getRoot());
+            return program;
+        }
+
+    private:
+        // Default members
+        Tree* myAST;
+        SymbolTable* mySymTable;
+        HashNode* currentHash;
+
+        // Program being lowered
+        IRProgram program;
+
+        // Lowers a statement (or a Block of them)
+        void lowerStatement(Node* node)
+        {
+            string name = node->getName();
+
+            if (name == "Block")
+            {
+                // Move into the first scope under this one that wasn't lowered yet (the outermost Block is the root scope)
+                if (node->getParent())
+                {
+                    vector<HashNode*> hashChildren = currentHash->getChildren();
+                    int index = 0;
+                    do
+                    {
+                        currentHash = hashChildren[index];
+                        index++;
+                    }
+                    while (currentHash->checkTraversed());
+                }
+
+                for (Node* child : node->getChildren())
+                {
+                    lowerStatement(child);
+                }
+
+                currentHash->setTraversed();
+                currentHash = currentHash->getParent();
+            }
+            // Variables start as 0 (false), except strings which have no pointer until they are assigned
+            else if (name == "Declare")
+            {
+                string type = node->getChild(0)->getName();
+                IRValue variable = program.addSymbol(node->getChild(1)->getName(), currentHash->getName(), type);
+                if (type != "string")
+                {
+                    emit("copy", variable, IRValue('c', 0), IRValue(), -1, node);
+                }
+            }
+            else if (name == "Assign")
+            {
+                lowerInto(node->getChild(1), resolve(node->getChild(0)->getName()));
+            }
+            else if (name == "Print")
+            {
+                Node* printValue = node->getChild(0);
+                string op = "print";
+                if (typeOf(printValue) == "string")
+                {
+                    op = "prints";
+                }
+                emit(op, IRValue(), lowerValue(printValue), IRValue(), -1, node);
+            }
+            // Skips the block when the condition is false
+            else if (name == "If")
+            {
+                int endLabel = program.newLabel();
+                branchIfFalse(node->getChild(0), endLabel, node);
+                lowerStatement(node->getChild(1));
+                program.startBlock(endLabel);
+            }
+            // Tests at the top and jumps back to it after the block
+            else if (name == "While")
+            {
+                int topLabel = program.newLabel();
+                int endLabel = program.newLabel();
+                program.startBlock(topLabel);
+                branchIfFalse(node->getChild(0), endLabel, node);
+                lowerStatement(node->getChild(1));
+                emit("jump", IRValue(), IRValue(), IRValue(), topLabel, node);
+                program.startBlock(endLabel);
+            }
+        }
+
+        // Branches to a label if a condition is false
+        void branchIfFalse(Node* condition, const int label, Node* owner)
+        {
+            string name = condition->getName();
+            if (name == "isEq" || name == "isNotEq")
+            {
+                IRValue first = lowerValue(condition->getChild(0));
+                IRValue second = lowerValue(condition->getChild(1));
+                string op = "bne";
+                if (name == "isNotEq")
+                {
+                    op = "beq";
+                }
+                emit(op, IRValue(), first, second, label, condition);
+            }
+            // Literals are known, so the block always runs (true) or never does (false)
+            else if (name == "false")
+            {
+                emit("jump", IRValue(), IRValue(), IRValue(), label, owner);
+            }
+            else if (name != "true")
+            {
+                emit("bne", IRValue(), lowerValue(condition), IRValue('c', 1), label, condition);
+            }
+        }
+
+        // Lowers an expression into a value (leaves are used as they are, anything else goes into a new temp)
+        IRValue lowerValue(Node* node)
+        {
+            if (!node->isLeaf())
+            {
+                IRValue temp = program.newTemp();
+                lowerInto(node, temp);
+                return temp;
+            }
+
+            string name = node->getName();
+            string tokenType = node->getToken()->getType();
+            if (tokenType == "ID")
+            {
+                return resolve(name);
+            }
+            else if (name == "true")
+            {
+                return IRValue('c', 1);
+            }
+            else if (name == "false")
+            {
+                return IRValue('c', 0);
+            }
+            else if (tokenType == "DIGIT")
+            {
+                return IRValue('c', stoi(name));
+            }
+            return program.addString(name);
+        }
+
+        // Lowers an expression straight into a variable or temp
+        void lowerInto(Node* node, const IRValue dest)
+        {
+            string name = node->getName();
+            if (node->isLeaf())
+            {
+                emit("copy", dest, lowerValue(node), IRValue(), -1, node);
+            }
+            else if (name == "ADD")
+            {
+                IRValue second = lowerValue(node->getChild(1));
+                IRValue first = lowerValue(node->getChild(0));
+                emit("add", dest, first, second, -1, node);
+            }
+            else if (name == "isEq" || name == "isNotEq")
+            {
+                IRValue first = lowerValue(node->getChild(0));
+                IRValue second = lowerValue(node->getChild(1));
+                string op = "eq";
+                if (name == "isNotEq")
+                {
+                    op = "ne";
+                }
+                emit(op, dest, first, second, -1, node);
+            }
+        }
+
+        // Adds an instruction to the current block
+        void emit(const string op, const IRValue dest, const IRValue first, const IRValue second, const int label, Node* node)
+        {
+            program.add(IRInstruction(op, dest, first, second, label, node));
+        }
+
+        // Finds the variable a name refers to: the last one declared with it in the current scope or one above it
+        IRValue resolve(const string name)
+        {
+            vector<IRSymbol>& symbols = program.getSymbols();
+            int found = -1;
+            for (int i = 0, n = symbols.size(); i < n; i++)
+            {
+                if (symbols[i].name != name)
+                {
+                    continue;
+                }
+
+                HashNode* node = currentHash;
+                while (node && node->getName() != symbols[i].scope)
+                {
+                    node = node->getParent();
+                }
+                if (node)
+                {
+                    found = i;
+                }
+            }
+            return IRValue('v', found);
+        }
+
+        // Type of a leaf or expression (int, string, or boolean)
+        string typeOf(Node* node)
+        {
+            string name = node->getName();
+            if (name == "ADD")
+            {
+                return "int";
+            }
+            else if (name == "isEq" || name == "isNotEq")
+            {
+                return "boolean";
+            }
+
+            string tokenType = node->getToken()->getType();
+            if (tokenType == "ID")
+            {
+                return program.getSymbols()[resolve(name).index].type;
+            }
+            else if (tokenType == "DIGIT")
+            {
+                return "int";
+            }
+            else if (tokenType == "BOOL_VAL")
+            {
+                return "boolean";
+            }
+            return "string";
+        }
+
+        // Marks every scope in the Symbol Table as not traversed
+        void resetTraversed(HashNode* node)
+        {
+            node->resetTraversed();
+            for (HashNode* child : node->getChildren())
+            {
+                resetTraversed(child);
+            }
+        }
+};
+
+#endif
\ No newline at end of file
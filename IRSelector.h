@@ -0,0 +1,847 @@
+#ifndef IRSELECTOR_H
+#define IRSELECTOR_H
+
+using namespace std;
+
+// Selects 6502 instructions for a program in three-address IR
+// Temps that are read once are folded back into expression trees, and each tree is covered with the rules in TREE_RULES by
+// dynamic programming (BURS style): every node is labeled bottom up with the cheapest way to reduce it to each nonterminal,
+// and the statement picks the cheapest way to use it. Costs are bytes or cycles from OP_CODES (the other one breaks ties)
+// Variables get the first static slots in the order they were declared, and temps get a slot the first time they are written
+// (with the temps pass, a slot is given out again after the last instruction that reads it)
+// Operands stay symbolic like the ones Code Gen emits, so the instructions go through the same string layout, peephole, and backpatching
+class IRSelector
+{
+    public:
+        // Default constructor for the IRSelector class
+        IRSelector(IRProgram& progIR, Options progOptions) : program(progIR)
+        {
+            this->options = progOptions;
+            this->target = options.getTarget();
+            this->forSize = options.getCostModel() == "size";
+        }
+
+        // Selects the instructions for every block
+        // If a branch is left with no place for a hop, it selects again without folding temps into trees (every IR instruction
+        // is a statement then, so there is a boundary between each of them)
+        vector<Instruction> select()
+        {
+            foldTrees = true;
+            selectBlocks();
+            if (target.isPaged() && !relaxBranches())
+            {
+                foldTrees = false;
+                selectBlocks();
+                relaxBranches();
+            }
+            return code;
+        }
+
+        // What each temp slot after the variables was made for (the AST Node the temp was lowered from, like ADD or isEq)
+        vector<string> getTempKinds()
+        {
+            return this->slotKinds;
+        }
+
+    private:
+        // Default members
+        IRProgram& program;
+        Options options;
+        Target target;
+
+        // Selects the instructions for every block, without relaxing the branches
+        void selectBlocks()
+        {
+            code.clear();
+            trees.clear();
+            slotKinds.clear();
+            freeSlots.clear();
+            slottedTemps.clear();
+            pendingTrees.clear();
+            labelCount = program.getLabelCount();
+            symbolCount = program.getSymbols().size();
+            tempSlots.assign(program.getTempCount(), -1);
+            findLastUses();
+            countUses();
+
+            // Begin each program with loading accumulator with 0 (the OS can jump to 0x00 from a loop at the start)
+            currentNode = nullptr;
+            emit("A9", "00");
+
+            int position = 0;
+            boundaries.clear();
+            for (IRBlock& block : program.getBlocks())
+            {
+                code.emplace_back(Instruction::label(block.label));
+                for (IRInstruction& instruction : block.instructions)
+                {
+                    // Operands are trees: temps waiting to be read are taken in, anything else is a leaf
+                    currentNode = instruction.node;
+                    int first = takeTree(instruction.first);
+                    int second = takeTree(instruction.second);
+
+                    // A temp that is read once waits for the instruction that reads it (instructions between them only write temps)
+                    bool waits = foldTrees && instruction.dest.kind == 't' && useCounts[instruction.dest.index] == 1 && !instruction.isBranch();
+                    if (waits)
+                    {
+                        pendingTrees[instruction.dest.index] = {position, valueTree(instruction, first, second)};
+                    }
+                    else
+                    {
+                        // Anything still waiting has to be written first, before this can write over what it reads
+                        flushPending();
+                        selectStatement(instruction, first, second, position);
+                    }
+                    position++;
+                }
+                flushPending();
+            }
+
+            currentNode = nullptr;
+            emit("00");
+        }
+
+        // Instructions selected so far, and the Node they are being selected for
+        vector<Instruction> code;
+        Node* currentNode = nullptr;
+
+        // Labels after the ones in the IR (for branches inside an instruction)
+        int labelCount = 0;
+
+        // Slot of every temp (-1 until it is written), and the kind of every temp slot after the variables
+        int symbolCount = 0;
+        vector<int> tempSlots;
+        vector<string> slotKinds;
+
+        // Positions in the code where an IR instruction starts (nothing is in the X register or the Z flag there)
+        set<int> boundaries;
+
+        // Size of a hop (LDX, CPX, BNE), and most times hops are added before giving up on the branches
+        static const int HOP_SIZE = 7;
+        static const int MAX_HOPS = 256;
+
+        // Bytes a hop leaves between itself and the branch it was placed for (room for later hops), if there is a place that can
+        static const int HOP_SLACK = 4 * HOP_SIZE;
+
+        // Temp slots that can be given out again, the position of the last instruction that reads each temp, and how many read it
+        set<int> freeSlots;
+        vector<int> lastUses;
+        vector<int> useCounts;
+        set<int> slottedTemps;
+
+        // Expression trees, and the ones whose temp hasn't been read yet (with the position of the instruction that wrote it)
+        vector<IRTree> trees;
+        map<int, pair<int, int>> pendingTrees;
+
+        // Whether costs are bytes first (size) or cycles first (speed)
+        bool forSize;
+
+        // Whether or not temps that are read once are folded into the tree of the instruction that reads them
+        bool foldTrees = true;
+
+        // Costs no reduction can reach
+        static const long long UNREACHABLE = LLONG_MAX / 4;
+
+        // Selects the instructions for a statement (an instruction with trees for its operands)
+        void selectStatement(IRInstruction& instruction, const int first, const int second, const int position)
+        {
+            currentNode = instruction.node;
+            boundaries.insert(code.size());
+            string op = instruction.op;
+
+            if (instruction.dest.kind != ' ')
+            {
+                int value = valueTree(instruction, first, second);
+
+                // Adding a constant to the destination in place takes an INC for each 1, against computing it in A and storing it
+                int increments = incrementsOf(value, instruction.dest);
+                long long storeCost = trees[value].costs[REG_A] + costOf({"8D"});
+                if (increments >= 0 && increments * costOf({"EE"}) < storeCost)
+                {
+                    for (int i = 0; i < increments; i++)
+                    {
+                        emit("EE", operandOf(instruction.dest));
+                    }
+                }
+                else
+                {
+                    reduce(value, REG_A);
+                    currentNode = instruction.node;
+                    emit("8D", operandOf(instruction.dest));
+                }
+            }
+            else if (op == "print")
+            {
+                reduce(first, REG_Y);
+                currentNode = instruction.node;
+                emit("A2", "01");
+                emit("FF");
+            }
+            // Strings are always leaves
+            else if (op == "prints")
+            {
+                printString(instruction.first);
+            }
+            else if (op == "bne" || op == "beq")
+            {
+                selectBranch(instruction, newTree("eq", IRValue(), first, second, instruction.node));
+            }
+            else if (op == "jump")
+            {
+                emitJump(instruction.label);
+            }
+            releaseTemps(position);
+        }
+
+        // Branches on a compare: BNE when the Z flag says the branch is taken when clear, a BNE over a jump when it is the other way around,
+        // or just a jump (or nothing) when both sides are constants
+        void selectBranch(IRInstruction& instruction, const int condition)
+        {
+            IRTree& tree = trees[condition];
+
+            // bne branches when the values are different (the eq is false), beq when they are equal (the eq is true)
+            bool onTrue = instruction.op == "beq";
+            Nonterminal direct = FLAG_Z;
+            Nonterminal inverted = FLAG_NZ;
+            if (onTrue)
+            {
+                swap(direct, inverted);
+            }
+
+            long long jumpCost = costOf({"A2", "EC", "D0"});
+            long long directCost = tree.costs[direct] + costOf({"D0"});
+            long long invertedCost = tree.costs[inverted] + costOf({"D0"}) + jumpCost;
+            if (tree.isConstant)
+            {
+                if ((tree.constant == 1) == onTrue)
+                {
+                    emitJump(instruction.label);
+                }
+                return;
+            }
+
+            if (directCost <= invertedCost)
+            {
+                reduce(condition, direct);
+                currentNode = instruction.node;
+                emitBranch(instruction.label);
+            }
+            else
+            {
+                reduce(condition, inverted);
+                currentNode = instruction.node;
+                int skipLabel = labelCount++;
+                emitBranch(skipLabel);
+                emitJump(instruction.label);
+                code.emplace_back(Instruction::label(skipLabel));
+            }
+        }
+
+        // Tree for the value an instruction computes (the operand tree of a copy, or a new node for add, eq, and ne)
+        int valueTree(IRInstruction& instruction, const int first, const int second)
+        {
+            if (instruction.op == "copy")
+            {
+                return first;
+            }
+            return newTree(instruction.op, IRValue(), first, second, instruction.node);
+        }
+
+        // Tree for an operand: the tree waiting for a temp, or a leaf (-1 if there is no operand)
+        int takeTree(const IRValue value)
+        {
+            if (value.kind == ' ')
+            {
+                return -1;
+            }
+            if (value.kind == 't')
+            {
+                auto pending = pendingTrees.find(value.index);
+                if (pending != pendingTrees.end())
+                {
+                    int tree = pending->second.second;
+                    pendingTrees.erase(pending);
+                    return tree;
+                }
+            }
+            return newTree("leaf", value, -1, -1, currentNode);
+        }
+
+        // Writes every tree still waiting into its temp, in the order they were written
+        void flushPending()
+        {
+            vector<pair<int, int>> waiting;
+            for (auto& pending : pendingTrees)
+            {
+                waiting.push_back({pending.second.first, pending.first});
+            }
+            sort(waiting.begin(), waiting.end());
+            for (auto& entry : waiting)
+            {
+                int tree = pendingTrees[entry.second].second;
+                pendingTrees.erase(entry.second);
+                IRInstruction write = IRInstruction("copy", IRValue('t', entry.second), IRValue(), IRValue(), -1, trees[tree].node);
+                selectStatement(write, tree, -1, entry.first);
+            }
+        }
+
+        // Adds a tree node and labels it (its children are already labeled)
+        int newTree(const string op, const IRValue value, const int left, const int right, Node* node)
+        {
+            trees.emplace_back(op, value, left, right, node);
+            int index = trees.size() - 1;
+            label(index);
+            return index;
+        }
+
+        // Finds the cheapest way to reduce a node to every nonterminal
+        void label(const int index)
+        {
+            IRTree& tree = trees[index];
+            for (int nt = 0; nt < NONTERMINAL_COUNT; nt++)
+            {
+                tree.costs[nt] = UNREACHABLE;
+                tree.rules[nt] = -1;
+                tree.swapped[nt] = false;
+                tree.from[nt] = IMM;
+            }
+
+            if (tree.op == "leaf")
+            {
+                // Constants and string pointers are immediates, variables and temps are in memory
+                if (tree.value.inMemory())
+                {
+                    relax(index, MEM, 0, LEAF, false, MEM);
+                }
+                else
+                {
+                    tree.isConstant = tree.value.kind == 'c';
+                    tree.constant = tree.value.index;
+                    relax(index, IMM, 0, LEAF, false, IMM);
+                }
+            }
+            else
+            {
+                labelOperator(index);
+            }
+
+            // Chain rules until nothing gets cheaper (each pass can only add one more step)
+            for (int pass = 0; pass < NONTERMINAL_COUNT; pass++)
+            {
+                bool changed = false;
+                for (int r = 0, n = TREE_RULES.size(); r < n; r++)
+                {
+                    const TreeRule& rule = TREE_RULES[r];
+                    if (rule.op == "" && trees[index].costs[rule.left] < UNREACHABLE)
+                    {
+                        changed |= relax(index, rule.result, trees[index].costs[rule.left] + costOf(rule.opCodes), r, false, rule.left);
+                    }
+                }
+                if (!changed)
+                {
+                    break;
+                }
+            }
+        }
+
+        // Labels an add, eq, or ne node from its children: operator rules, folding constants, and testing a compare against 0 or 1 again
+        void labelOperator(const int index)
+        {
+            IRTree& tree = trees[index];
+            IRTree& left = trees[tree.left];
+            IRTree& right = trees[tree.right];
+
+            for (int r = 0, n = TREE_RULES.size(); r < n; r++)
+            {
+                const TreeRule& rule = TREE_RULES[r];
+                if (rule.op != tree.op)
+                {
+                    continue;
+                }
+                relax(index, rule.result, left.costs[rule.left] + right.costs[rule.right] + costOf(rule.opCodes), r, false, rule.left);
+                relax(index, rule.result, right.costs[rule.left] + left.costs[rule.right] + costOf(rule.opCodes), r, true, rule.left);
+            }
+
+            // ADC wraps around without a carry, and compares give 1 or 0
+            if (left.isConstant && right.isConstant)
+            {
+                tree.isConstant = true;
+                if (tree.op == "add")
+                {
+                    tree.constant = (left.constant + right.constant) & 0xFF;
+                }
+                else if (tree.op == "eq")
+                {
+                    tree.constant = left.constant == right.constant;
+                }
+                else
+                {
+                    tree.constant = left.constant != right.constant;
+                }
+                relax(index, IMM, 0, FOLD, false, IMM);
+            }
+
+            // A compare tested against 1 (or 0) has the same Z flag as the compare (or the opposite one)
+            if (tree.op == "eq" || tree.op == "ne")
+            {
+                retest(index, tree.left, tree.right, false);
+                retest(index, tree.right, tree.left, true);
+            }
+        }
+
+        // Labels a node that tests a compare against a constant 0 or 1 with the compare's Z flag
+        void retest(const int index, const int compare, const int constant, const bool swapped)
+        {
+            IRTree& inner = trees[compare];
+            IRTree& value = trees[constant];
+            if ((inner.op != "eq" && inner.op != "ne") || !value.isConstant || (value.constant != 0 && value.constant != 1))
+            {
+                return;
+            }
+
+            // The node is true when the compare is, unless it tests for 0 or it is an ne (but not both)
+            bool same = (value.constant == 1) == (trees[index].op == "eq");
+            Nonterminal whenTrue = FLAG_NZ;
+            Nonterminal whenFalse = FLAG_Z;
+            if (same)
+            {
+                swap(whenTrue, whenFalse);
+            }
+            relax(index, FLAG_Z, inner.costs[whenTrue], RETEST, swapped, whenTrue);
+            relax(index, FLAG_NZ, inner.costs[whenFalse], RETEST, swapped, whenFalse);
+        }
+
+        // Records a way to reduce a node to a nonterminal if it is cheaper than the one it has, returns whether it was
+        bool relax(const int index, const Nonterminal nt, const long long cost, const int rule, const bool swapped, const Nonterminal from)
+        {
+            IRTree& tree = trees[index];
+            if (cost >= UNREACHABLE || cost >= tree.costs[nt])
+            {
+                return false;
+            }
+            tree.costs[nt] = cost;
+            tree.rules[nt] = rule;
+            tree.swapped[nt] = swapped;
+            tree.from[nt] = from;
+            return true;
+        }
+
+        // Emits the instructions that reduce a tree to a nonterminal the way labeling picked
+        // (after reducing to IMM or MEM, the operand holds the immediate or the address)
+        void reduce(const int index, const Nonterminal nt)
+        {
+            int rule = trees[index].rules[nt];
+            Nonterminal from = trees[index].from[nt];
+
+            if (rule == LEAF)
+            {
+                trees[index].operand = operandOf(trees[index].value);
+                return;
+            }
+            else if (rule == FOLD)
+            {
+                trees[index].operand = toHex(trees[index].constant);
+                return;
+            }
+            else if (rule == RETEST)
+            {
+                int compare = trees[index].left;
+                if (trees[index].swapped[nt])
+                {
+                    compare = trees[index].right;
+                }
+                reduce(compare, from);
+                return;
+            }
+
+            const TreeRule& treeRule = TREE_RULES[rule];
+            if (treeRule.op == "")
+            {
+                reduce(index, from);
+                currentNode = trees[index].node;
+                if (nt == MEM)
+                {
+                    string slot = newSlot();
+                    emit(treeRule.opCodes[0], slot);
+                    trees[index].operand = slot;
+                    trees[index].spill = slot;
+                }
+                else if (from == FLAG_Z || from == FLAG_NZ)
+                {
+                    // Start with the value for a clear Z flag and change it if the flag is set
+                    string clear = "00";
+                    string set = "01";
+                    if (from == FLAG_NZ)
+                    {
+                        swap(clear, set);
+                    }
+                    int skipLabel = labelCount++;
+                    emit("A9", clear);
+                    emitBranch(skipLabel);
+                    emit("A9", set);
+                    code.emplace_back(Instruction::label(skipLabel));
+                }
+                else
+                {
+                    emit(treeRule.opCodes[0], trees[index].operand);
+                    if (trees[index].spill != "")
+                    {
+                        releaseSlot(trees[index].spill);
+                    }
+                }
+                return;
+            }
+
+            // Operator rules: the memory side goes first since the register side has to stay in its register
+            int registerSide = trees[index].left;
+            int memorySide = trees[index].right;
+            if (trees[index].swapped[nt])
+            {
+                swap(registerSide, memorySide);
+            }
+            reduce(memorySide, treeRule.right);
+            reduce(registerSide, treeRule.left);
+            currentNode = trees[index].node;
+            emit(treeRule.opCodes[0], trees[memorySide].operand);
+            if (trees[memorySide].spill != "")
+            {
+                releaseSlot(trees[memorySide].spill);
+            }
+        }
+
+        // Number of INCs that turn the destination into a tree's value (it adds a constant to the destination), -1 if it doesn't
+        int incrementsOf(const int index, const IRValue dest)
+        {
+            IRTree& tree = trees[index];
+            if (tree.op != "add" || dest.kind != 'v')
+            {
+                return -1;
+            }
+            IRTree& left = trees[tree.left];
+            IRTree& right = trees[tree.right];
+            if (left.op == "leaf" && left.value == dest && right.isConstant)
+            {
+                return right.constant;
+            }
+            else if (right.op == "leaf" && right.value == dest && left.isConstant)
+            {
+                return left.constant;
+            }
+            return -1;
+        }
+
+        // Cost of a run of op codes: bytes then cycles for size, cycles then bytes for speed
+        long long costOf(const vector<string>& opCodes)
+        {
+            long long size = 0;
+            long long cycles = 0;
+            for (const string& opCode : opCodes)
+            {
+                size += OP_CODES.at(opCode).size;
+                cycles += OP_CODES.at(opCode).cycles;
+            }
+            if (forSize)
+            {
+                return size * 10000 + cycles;
+            }
+            return cycles * 10000 + size;
+        }
+
+        // Brings every branch in range by sending the ones that are too far through a hop placed between IR instructions
+        // Code running into a hop jumps over it, so a hop takes two unconditional branches (one to skip it and the one it makes)
+        // Only the zero page wraps around, so branches on anything bigger can be out of range (false if one still is)
+        bool relaxBranches()
+        {
+            for (int hops = 0; hops < MAX_HOPS; hops++)
+            {
+                // Address of every instruction and label
+                vector<int> addresses;
+                unordered_map<string, int> labels;
+                int address = 0;
+                for (Instruction& instruction : code)
+                {
+                    if (instruction.isLabel())
+                    {
+                        labels[instruction.getOperand()] = address;
+                    }
+                    addresses.emplace_back(address);
+                    address += instruction.getSize();
+                }
+
+                // Find the first branch out of range (offsets are from the instruction after it, -128 to 127)
+                int far = -1;
+                for (int i = 0, n = code.size(); i < n && far < 0; i++)
+                {
+                    if (code[i].getMnemonic() == "BNE")
+                    {
+                        int offset = labels[code[i].getOperand()] - (addresses[i] + 2);
+                        if (offset > 127 || offset < -128)
+                        {
+                            far = i;
+                        }
+                    }
+                }
+                if (far < 0)
+                {
+                    return true;
+                }
+
+                // Place the hop as close to the label as the branch reaches (a hop before the branch moves it down)
+                // The hop has to bring the branch nearer than the code it adds, or hops for different branches just push each other along
+                // It leaves room for a few hops placed later between them if it can, so they don't push the branch out of range again
+                int from = addresses[far] + 2;
+                int to = labels[code[far].getOperand()];
+                int place = -1;
+                for (int slack : {HOP_SLACK, 0})
+                {
+                    for (int boundary : boundaries)
+                    {
+                        int at = addresses[boundary];
+                        if (to > from && boundary > far && at > from + 2 * HOP_SIZE && at < to && at + HOP_SIZE - from <= 127 - slack)
+                        {
+                            place = boundary;
+                        }
+                        else if (to < from && boundary <= far && at > to && at + 4 * HOP_SIZE < from && from + 2 * HOP_SIZE - (at + HOP_SIZE) <= 128 - slack && place < 0)
+                        {
+                            place = boundary;
+                        }
+                    }
+                    if (place >= 0)
+                    {
+                        break;
+                    }
+                }
+                if (place < 0)
+                {
+                    return false;
+                }
+
+                // Skip the hop, or land on it and branch to where the far branch was going
+                string farLabel = code[far].getOperand();
+                int hopLabel = labelCount++;
+                int skipLabel = labelCount++;
+                currentNode = code[far].getNode();
+                vector<Instruction> hop;
+                hop.emplace_back("A2", "01", currentNode);
+                hop.emplace_back("EC", toAddress(target.getScratchAddress()), currentNode);
+                hop.emplace_back("D0", "L" + to_string(skipLabel), currentNode);
+                hop.emplace_back(Instruction::label(hopLabel));
+                hop.emplace_back("A2", "01", currentNode);
+                hop.emplace_back("EC", toAddress(target.getScratchAddress()), currentNode);
+                hop.emplace_back("D0", farLabel, currentNode);
+                hop.emplace_back(Instruction::label(skipLabel));
+                code[far].setOperand("L" + to_string(hopLabel));
+                code.insert(code.begin() + place, hop.begin(), hop.end());
+
+                // Boundaries after the hop move down with the code, and the end of the hop is one too
+                set<int> moved;
+                for (int boundary : boundaries)
+                {
+                    if (boundary > place)
+                    {
+                        boundary += hop.size();
+                    }
+                    moved.insert(boundary);
+                }
+                moved.insert(place + hop.size());
+                boundaries = moved;
+            }
+            return false;
+        }
+
+        // Prints a string (outside of the zero page, the system call takes its address as an operand)
+        void printString(IRValue value)
+        {
+            if (!target.isPaged())
+            {
+                load("Y", value);
+                emit("A2", "02");
+                emit("FF");
+            }
+            // Literals point straight to the heap
+            else if (value.kind == 's')
+            {
+                emit("A2", "03");
+                emit("FF", operandOf(value));
+            }
+            // Copy the variable's pointer into the operand of the system call (its high byte is always the heap page)
+            else
+            {
+                int callLabel = labelCount++;
+                load("A", value);
+                emit("8D", "L" + to_string(callLabel) + "+1");
+                emit("A2", "03");
+                code.emplace_back(Instruction::label(callLabel));
+                emit("FF", toAddress(target.getHeapPage() << 8));
+            }
+        }
+
+        // Loads a value into a register
+        void load(const string reg, const IRValue value)
+        {
+            string immediate = "A9";
+            string absolute = "AD";
+            if (reg == "X")
+            {
+                immediate = "A2";
+                absolute = "AE";
+            }
+            else if (reg == "Y")
+            {
+                immediate = "A0";
+                absolute = "AC";
+            }
+
+            if (value.inMemory())
+            {
+                emit(absolute, operandOf(value));
+            }
+            else
+            {
+                emit(immediate, operandOf(value));
+            }
+        }
+
+        // Symbolic operand of a value (T0 for a static slot, S0 for a pooled string, or hex for a constant)
+        string operandOf(const IRValue value)
+        {
+            if (value.kind == 'v')
+            {
+                return "T" + to_string(value.index);
+            }
+            else if (value.kind == 't')
+            {
+                if (tempSlots[value.index] < 0)
+                {
+                    tempSlots[value.index] = stoi(newSlot().substr(1));
+                    slottedTemps.insert(value.index);
+                }
+                return "T" + to_string(tempSlots[value.index]);
+            }
+            else if (value.kind == 's')
+            {
+                return "S" + to_string(value.index);
+            }
+            return toHex(value.index);
+        }
+
+        // Gets a temp slot (one that was given back first when temps are reused)
+        string newSlot()
+        {
+            if (options.isEnabled("temps") && !freeSlots.empty())
+            {
+                int slot = *freeSlots.begin();
+                freeSlots.erase(freeSlots.begin());
+                return "T" + to_string(slot);
+            }
+
+            string kind = "IR";
+            if (currentNode)
+            {
+                kind = currentNode->getName();
+            }
+            slotKinds.emplace_back(kind);
+            return "T" + to_string(symbolCount + slotKinds.size() - 1);
+        }
+
+        // Gives a temp slot back once nothing reads it anymore
+        void releaseSlot(const string slot)
+        {
+            if (options.isEnabled("temps"))
+            {
+                freeSlots.insert(stoi(slot.substr(1)));
+            }
+        }
+
+        // Gives back the slot of every temp that nothing after a position reads (trees read their temps when the statement is selected)
+        void releaseTemps(const int position)
+        {
+            for (int temp : set<int>(slottedTemps))
+            {
+                if (lastUses[temp] <= position)
+                {
+                    releaseSlot("T" + to_string(tempSlots[temp]));
+                    tempSlots[temp] = -1;
+                    slottedTemps.erase(temp);
+                }
+            }
+        }
+
+        // Counts how many instructions read each temp
+        void countUses()
+        {
+            useCounts.assign(program.getTempCount(), 0);
+            for (IRBlock& block : program.getBlocks())
+            {
+                for (IRInstruction& instruction : block.instructions)
+                {
+                    for (IRValue value : {instruction.first, instruction.second})
+                    {
+                        if (value.kind == 't')
+                        {
+                            useCounts[value.index]++;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Finds the last instruction that reads each temp (temps are only read in the statement they are written in)
+        void findLastUses()
+        {
+            lastUses.assign(program.getTempCount(), -1);
+            int position = 0;
+            for (IRBlock& block : program.getBlocks())
+            {
+                for (IRInstruction& instruction : block.instructions)
+                {
+                    for (IRValue value : {instruction.first, instruction.second})
+                    {
+                        if (value.kind == 't')
+                        {
+                            lastUses[value.index] = position;
+                        }
+                    }
+                    position++;
+                }
+            }
+        }
+
+        // Adds an instruction for the current Node
+        void emit(const string opCode, const string operand = "")
+        {
+            code.emplace_back(opCode, operand, currentNode);
+        }
+
+        // Branches to a label if not equal
+        void emitBranch(const int label)
+        {
+            emit("D0", "L" + to_string(label));
+        }
+
+        // Unconditional branch to a label (compares 1 to the 0x00 in the scratch cell)
+        void emitJump(const int label)
+        {
+            emit("A2", "01");
+            emit("EC", toAddress(target.getScratchAddress()));
+            emitBranch(label);
+        }
+
+        // Converts an address to hex with all 4 digits
+        string toAddress(const int address)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(4) << setfill('0') << address;
+            return result.str();
+        }
+
+        // Convert decimal to hexadecimal
+        string toHex(int num)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(2) << setfill('0') << num;
+            return result.str();
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+using namespace std;
+
+// Information about an op code in the 6502 instruction subset
+struct OpCode
+{
+    string mnemonic;
+    string mode;
+    int size;
+    int cycles;
+};
+
+// Every op code Code Gen can emit (mode is how the operand is written)
+// Cycles are the 6502 timings (a taken branch takes 1 more, and the system call is counted like a JSR since the OS handles it)
+const unordered_map<string, OpCode> OP_CODES = {
+    {"A9", {"LDA", "immediate", 2, 2}},
+    {"AD", {"LDA", "absolute", 3, 4}},
+    {"8D", {"STA", "absolute", 3, 4}},
+    {"6D", {"ADC", "absolute", 3, 4}},
+    {"A2", {"LDX", "immediate", 2, 2}},
+    {"AE", {"LDX", "absolute", 3, 4}},
+    {"A0", {"LDY", "immediate", 2, 2}},
+    {"AC", {"LDY", "absolute", 3, 4}},
+    {"EA", {"NOP", "implied", 1, 2}},
+    {"00", {"BRK", "implied", 1, 7}},
+    {"EC", {"CPX", "absolute", 3, 4}},
+    {"D0", {"BNE", "relative", 2, 2}},
+    {"EE", {"INC", "absolute", 3, 6}},
+    {"FF", {"SYS", "implied", 1, 6}}
+};
+
+// A single instruction before it is placed in the runtime environment
+// Operands stay symbolic until then: temporary addresses (T0), labels (L0, or L0+1 for a byte after a label), pooled strings (S0), or hex
+class Instruction
+{
+    public:
+        // Constructor for an instruction (node is the AST Node it was generated for)
+        Instruction(const string newOpCode, const string newOperand, Node* newNode)
+        {
+            this->opCode = newOpCode;
+            this->operand = newOperand;
+            this->node = newNode;
+            this->address = -1;
+        }
+
+        // Creates a label that marks a position in the code (takes up no space)
+        static Instruction label(const int id)
+        {
+            return Instruction("", "L" + to_string(id), nullptr);
+        }
+
+        // Getters
+        string getOpCode()
+        {
+            return this->opCode;
+        }
+
+        string getOperand()
+        {
+            return this->operand;
+        }
+
+        Node* getNode()
+        {
+            return this->node;
+        }
+
+        // Returns whether or not this is a label
+        bool isLabel()
+        {
+            return this->opCode == "";
+        }
+
+        // Getters for information from the op code table
+        string getMnemonic()
+        {
+            if (isLabel())
+            {
+                return "";
+            }
+            return OP_CODES.at(opCode).mnemonic;
+        }
+
+        string getMode()
+        {
+            if (isLabel())
+            {
+                return "label";
+            }
+            // The system call only has an operand when printing a string with $03 in the X register
+            else if (opCode == "FF" && operand != "")
+            {
+                return "absolute";
+            }
+            return OP_CODES.at(opCode).mode;
+        }
+
+        int getCycles()
+        {
+            if (isLabel())
+            {
+                return 0;
+            }
+            return OP_CODES.at(opCode).cycles;
+        }
+
+        int getSize()
+        {
+            if (isLabel())
+            {
+                return 0;
+            }
+            else if (getMode() == "absolute")
+            {
+                return 3;
+            }
+            return OP_CODES.at(opCode).size;
+        }
+
+        // Setter for operand (used when an optimization rewrites an instruction)
+        void setOperand(const string newOperand)
+        {
+            this->operand = newOperand;
+        }
+
+        // Setter and getter for the address the instruction was placed at (-1 until it is assembled)
+        void setAddress(const int newAddress)
+        {
+            this->address = newAddress;
+        }
+
+        int getAddress()
+        {
+            return this->address;
+        }
+
+        // Setter and getter for the symbolic operand the instruction had before it was resolved (like S0 for a string)
+        void setSymbol(const string newSymbol)
+        {
+            this->symbol = newSymbol;
+        }
+
+        string getSymbol()
+        {
+            return this->symbol;
+        }
+
+    private:
+        // Members
+        string opCode;
+        string operand;
+        Node* node;
+        int address;
+        string symbol;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,247 @@
+#ifndef LISTING_H
+#define LISTING_H
+
+using namespace std;
+
+// Prints the code Code Gen placed as an assembly listing, with a line for every instruction:
+//   address, bytes, mnemonic and operand, what the operand refers to, cycles, and the statement it was generated for
+// Followed by what is in static data and the heap, and the totals for each region
+class Listing
+{
+    public:
+        // Default constructor for the Listing class (code gen has to have placed the program without an error)
+        Listing(const int progNum, CodeGen& codeGen, Target progTarget)
+        {
+            this->programNumber = progNum;
+            this->target = progTarget;
+            this->image = codeGen.getImage();
+            this->code = codeGen.getCode();
+            this->staticNames = codeGen.getStaticNames();
+            this->strings = codeGen.getStrings();
+            this->stringAddresses = codeGen.getStringAddresses();
+            this->codeSize = codeGen.getCodeSize();
+            this->staticSize = codeGen.getStaticSize();
+            this->heapSize = codeGen.getHeapSize();
+        }
+
+        // Logs the listing
+        void print()
+        {
+            log("INFO", "Listing for Program #" + to_string(programNumber));
+            log("INFO", column("ADDR", 6) + column("BYTES", 10) + column("INSTRUCTION", 13) + column("REFERS TO", 20) + column("CYCLES", 8) + "SOURCE");
+
+            for (Instruction& instruction : code)
+            {
+                // Labels get their own line so branches can be followed
+                if (instruction.isLabel())
+                {
+                    log("INFO", column("", 6) + instruction.getOperand() + ":");
+                    continue;
+                }
+
+                int address = instruction.getAddress();
+                string bytes = "";
+                for (int i = 0; i < instruction.getSize(); i++)
+                {
+                    bytes += image[address + i] + " ";
+                }
+
+                // Branches take longer when they are taken
+                string cycles = to_string(instruction.getCycles());
+                if (instruction.getMode() == "relative")
+                {
+                    cycles += "+";
+                }
+
+                log("INFO", column(toAddress(address), 6) + column(bytes, 10) + column(assembly(instruction), 13) + column(refersTo(instruction), 20) + column(cycles, 8) + describe(statementOf(instruction.getNode())));
+            }
+
+            // Static data comes right after the code
+            log("INFO", "Static data for Program #" + to_string(programNumber));
+            for (int i = 0, n = staticNames.size(); i < n; i++)
+            {
+                log("INFO", column(toAddress(codeSize + i), 6) + column(image[codeSize + i], 10) + "T" + to_string(i) + " " + staticNames[i]);
+            }
+
+            // Strings from the lowest address up (a string that shares the end of another one points into it)
+            log("INFO", "Heap for Program #" + to_string(programNumber));
+            vector<int> order;
+            for (int i = 0, n = strings.size(); i < n; i++)
+            {
+                order.emplace_back(i);
+            }
+            sort(order.begin(), order.end(), [this](const int a, const int b)
+            {
+                if (stringAddresses[a] != stringAddresses[b])
+                {
+                    return stringAddresses[a] < stringAddresses[b];
+                }
+                return a < b;
+            });
+            for (int i : order)
+            {
+                log("INFO", column(toAddress(stringAddresses[i]), 6) + column(to_string(strings[i].length() + 1) + " byte(s)", 12) + "S" + to_string(i) + " \"" + strings[i] + "\"");
+            }
+            log("INFO", column(toAddress(target.getScratchAddress()), 6) + column("1 byte(s)", 12) + "scratch");
+
+            // Totals for each region (the scratch cell ends the top string, so it only counts as heap once there is one)
+            int heapStart = target.getScratchAddress() - heapSize + 1;
+            int freeEnd = min(heapStart, target.getScratchAddress());
+            log("INFO", "Code: " + range(0, codeSize) + ", Static: " + range(codeSize, staticSize) + ", Heap: " + range(heapStart, heapSize) + ", Free: " + to_string(freeEnd - codeSize - staticSize) + " byte(s)");
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Target target;
+
+        // What Code Gen placed
+        vector<string> image;
+        vector<Instruction> code;
+        vector<string> staticNames;
+        vector<string> strings;
+        vector<int> stringAddresses;
+        int codeSize;
+        int staticSize;
+        int heapSize;
+
+        // Mnemonic and operand of a placed instruction, read back from its bytes
+        string assembly(Instruction& instruction)
+        {
+            int address = instruction.getAddress();
+            string mode = instruction.getMode();
+            string text = instruction.getMnemonic();
+
+            if (mode == "immediate")
+            {
+                text += " #$" + image[address + 1];
+            }
+            else if (mode == "absolute")
+            {
+                text += " $" + image[address + 2] + image[address + 1];
+            }
+            // Branches show where they land
+            else if (mode == "relative")
+            {
+                int offset = (int8_t)stoi(image[address + 1], nullptr, 16);
+                int size = image.size();
+                text += " $" + toAddress((address + 2 + offset + size) % size);
+            }
+            return text;
+        }
+
+        // What the operand of an instruction refers to (a static slot, a string, a label, or the scratch cell)
+        string refersTo(Instruction& instruction)
+        {
+            string operand = instruction.getOperand();
+            string symbol = instruction.getSymbol();
+
+            if (symbol != "" && symbol[0] == 'S')
+            {
+                return "\"" + strings[stoi(symbol.substr(1))] + "\"";
+            }
+            else if (operand == "")
+            {
+                return "";
+            }
+            else if (operand[0] == 'T')
+            {
+                return staticNames[stoi(operand.substr(1))];
+            }
+            // Labels, and code addresses that are a label plus an offset
+            else if (operand[0] == 'L')
+            {
+                return operand;
+            }
+            else if (instruction.getMode() == "absolute" && stoi(operand, nullptr, 16) == target.getScratchAddress())
+            {
+                return "scratch";
+            }
+            return "";
+        }
+
+        // The statement a Node is part of (the child of a Block it is under)
+        Node* statementOf(Node* node)
+        {
+            while (node && node->getParent() && node->getParent()->getName() != "Block")
+            {
+                node = node->getParent();
+            }
+            return node;
+        }
+
+        // Name and position of a statement
+        string describe(Node* node)
+        {
+            if (!node)
+            {
+                return "Program start/end";
+            }
+
+            Token* token = node->getFirstToken();
+            if (!token)
+            {
+                return node->getName();
+            }
+            return node->getName() + " at (" + to_string(token->getLine()) + ":" + to_string(token->getColumn()) + ")";
+        }
+
+        // Start and end of a region with its size
+        string range(const int start, const int size)
+        {
+            if (size == 0)
+            {
+                return "0 byte(s)";
+            }
+            return to_string(size) + " byte(s) [" + toAddress(start) + "-" + toAddress(start + size - 1) + "]";
+        }
+
+        // Convert an address to 4 digit hexadecimal
+        string toAddress(const int address)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(4) << setfill('0') << address;
+            return result.str();
+        }
+
+        // Pads a value to a column width
+        string column(const string value, const int width)
+        {
+            string padded = value;
+            while ((int)padded.length() < width)
+            {
+                padded += " ";
+            }
+            return padded;
+        }
+
+        // Logging function for the listing
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Listing - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,275 @@
+#ifndef LOOPINVARIANTMOTION_H
+#define LOOPINVARIANTMOTION_H
+
+using namespace std;
+
+// Moves expressions in While loops that give the same value every time through the loop to right before the loop
+// The value is stored in a new variable ($0, $1, etc) that the loop reads instead (the Optimizer compiles the level again without
+// hoisting if the new variables make the program too big for memory)
+class LoopInvariantMotion
+{
+    public:
+        // Default constructor for the LoopInvariantMotion class
+        LoopInvariantMotion(const int progNum, Tree* progAST, SymbolTable* progSymTable)
+        {
+            this->programNumber = progNum;
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+        }
+
+        // Hoists invariant expressions out of every loop, returns how many were hoisted
+        int hoist()
+        {
+            hoistBlock(myAST->getRoot(), mySymTable->getRoot());
+            log("DEBUG", "Loop Invariants: Hoisted " + to_string(hoistCount) + " expression(s) in Program #" + to_string(programNumber));
+            return hoistCount;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Tree* myAST;
+        SymbolTable* mySymTable;
+
+        // Tokens for the new Nodes (deque so pointers to them stay valid)
+        deque<Token> hoistedTokens;
+
+        int hoistCount = 0;
+
+        // Looks for loops in every statement of a Block (scope is the Symbol Table scope that belongs to the Block)
+        void hoistBlock(Node* block, HashNode* scope)
+        {
+            // Child scopes are in the same order as the Blocks inside this one
+            int scopeIndex = 0;
+
+            for (Node* statement : block->getChildren())
+            {
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    hoistBlock(statement, scope->getChild(scopeIndex));
+                    scopeIndex++;
+                }
+                else if (name == "If" || name == "While")
+                {
+                    // Outer loops go first, so values get hoisted as far out as they can
+                    if (name == "While")
+                    {
+                        hoistLoop(statement, block, scope);
+                    }
+                    hoistBlock(statement->getChild(1), scope->getChild(scopeIndex));
+                    scopeIndex++;
+                }
+            }
+        }
+
+        // Hoists the invariant expressions of a loop to right before it
+        void hoistLoop(Node* loop, Node* block, HashNode* scope)
+        {
+            // Anything that uses a variable assigned (or declared) in the loop can change from one time to the next
+            set<string> assigned;
+            collectAssigned(loop->getChild(1), assigned);
+
+            // The condition has to stay a comparison, so only its values can be hoisted
+            vector<Node*> invariants;
+            for (Node* child : loop->getChild(0)->getChildren())
+            {
+                collectInvariants(child, assigned, invariants);
+            }
+            collectStatements(loop->getChild(1), assigned, invariants);
+
+            for (Node* expression : invariants)
+            {
+                hoistExpression(expression, loop, block, scope);
+            }
+        }
+
+        // Collects the invariant expressions of every statement in a Block (including nested ones)
+        void collectStatements(Node* block, set<string>& assigned, vector<Node*>& invariants)
+        {
+            for (Node* statement : block->getChildren())
+            {
+                string name = statement->getName();
+
+                if (name == "Block")
+                {
+                    collectStatements(statement, assigned, invariants);
+                }
+                else if (name == "Assign")
+                {
+                    collectInvariants(statement->getChild(1), assigned, invariants);
+                }
+                else if (name == "Print")
+                {
+                    collectInvariants(statement->getChild(0), assigned, invariants);
+                }
+                else if (name == "If" || name == "While")
+                {
+                    for (Node* child : statement->getChild(0)->getChildren())
+                    {
+                        collectInvariants(child, assigned, invariants);
+                    }
+                    collectStatements(statement->getChild(1), assigned, invariants);
+                }
+            }
+        }
+
+        // Collects the largest invariant expressions inside an expression (leaves are already as cheap as they get)
+        void collectInvariants(Node* node, set<string>& assigned, vector<Node*>& invariants)
+        {
+            if (node->isLeaf())
+            {
+                return;
+            }
+
+            if (isInvariant(node, assigned))
+            {
+                invariants.emplace_back(node);
+                return;
+            }
+
+            for (Node* child : node->getChildren())
+            {
+                collectInvariants(child, assigned, invariants);
+            }
+        }
+
+        // Returns whether or not an expression only reads variables the loop doesn't assign
+        bool isInvariant(Node* node, set<string>& assigned)
+        {
+            if (node->isLeaf())
+            {
+                return node->getToken()->getType() != "ID" || assigned.find(node->getName()) == assigned.end();
+            }
+
+            for (Node* child : node->getChildren())
+            {
+                if (!isInvariant(child, assigned))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Stores an expression in a new variable before the loop, and reads the variable in its place
+        void hoistExpression(Node* expression, Node* loop, Node* block, HashNode* scope)
+        {
+            // Sums are ints and comparisons are booleans
+            string type = "boolean";
+            if (expression->getName() == "ADD")
+            {
+                type = "int";
+            }
+
+            Token* token = expression->getToken();
+            string varName = "$" + to_string(hoistCount);
+            hoistCount++;
+            log("DEBUG", "Loop Invariants: Hoisting " + expression->getName() + " at (" + to_string(token->getLine()) + ":" + to_string(token->getColumn()) + ") into [" + varName + "]");
+
+            // Add the variable to the scope of the loop
+            scope->addValue(varName, type);
+            scope->setLineAndColumn(varName, token->getLine(), token->getColumn());
+            scope->setInitialized(varName);
+            scope->setUsed(varName);
+
+            // Read the variable where the expression was
+            expression->getParent()->replaceChild(expression, newLeaf("ID", varName, token));
+
+            // Declare the variable and assign the expression to it right before the loop
+            Node* declare = new Node();
+            declare->setName("Declare");
+            addChild(declare, newLeaf(typeTokenName(type), type, token));
+            addChild(declare, newLeaf("ID", varName, token));
+            block->insertChild(loop, declare);
+
+            Node* assign = new Node();
+            assign->setName("Assign");
+            addChild(assign, newLeaf("ID", varName, token));
+            addChild(assign, expression);
+            block->insertChild(loop, assign);
+        }
+
+        // Adds a child to a Node and links it back to its new parent
+        void addChild(Node* parent, Node* child)
+        {
+            parent->addChild(child);
+            child->setParent(parent);
+        }
+
+        // Creates a new leaf with its own token (at the position of another token)
+        Node* newLeaf(const string tokenType, const string value, Token* position)
+        {
+            hoistedTokens.emplace_back(tokenType, value, position->getLine(), position->getColumn());
+
+            Node* leaf = new Node();
+            leaf->setName(value);
+            leaf->setToLeaf();
+            leaf->linkToken(&hoistedTokens.back());
+            return leaf;
+        }
+
+        // Token type the Lexer gives to a type keyword
+        string typeTokenName(const string type)
+        {
+            if (type == "int")
+            {
+                return "I_VARTYPE";
+            }
+            return "B_VARTYPE";
+        }
+
+        // Collects the name of every variable assigned (or declared) inside a Block, including nested ones
+        void collectAssigned(Node* node, set<string>& assigned)
+        {
+            string name = node->getName();
+            if (name == "Assign")
+            {
+                assigned.insert(node->getChild(0)->getName());
+                return;
+            }
+            else if (name == "Declare")
+            {
+                assigned.insert(node->getChild(1)->getName());
+                return;
+            }
+            if (!node->isLeaf())
+            {
+                for (Node* child : node->getChildren())
+                {
+                    collectAssigned(child, assigned);
+                }
+            }
+        }
+
+        // Logging function for the optimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Optimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -79,6 +79,32 @@ class Node
             this->children.emplace_back(childNode);
         }
 
+        // Replaces a child with a different Node (used by optimizations that rewrite the AST)
+        void replaceChild(Node* oldChild, Node* newChild)
+        {
+            for (int i = 0, n = this->children.size(); i < n; i++)
+            {
+                if (this->children[i] == oldChild)
+                {
+                    this->children[i] = newChild;
+                    newChild->setParent(this);
+                }
+            }
+        }
+
+        // Inserts a child right before another one (used by optimizations that add statements to the AST)
+        void insertChild(Node* before, Node* newChild)
+        {
+            this->children.insert(find(this->children.begin(), this->children.end(), before), newChild);
+            newChild->setParent(this);
+        }
+
+        // Removes a child from the children vector (doesn't delete it)
+        void removeChild(Node* child)
+        {
+            this->children.erase(remove(this->children.begin(), this->children.end(), child), this->children.end());
+        }
+
         // Adds the token pointer for this class
         void linkToken(Token* newToken)
         {
@@ -91,6 +117,24 @@ class Node
             return this->tokenPointer;
         }
 
+        // Returns the first token in this Node or the Nodes under it (for Nodes without their own, like Assign and Print)
+        Token* getFirstToken()
+        {
+            if (this->tokenPointer != nullptr)
+            {
+                return this->tokenPointer;
+            }
+            for (Node* child : this->children)
+            {
+                Token* token = child->getFirstToken();
+                if (token != nullptr)
+                {
+                    return token;
+                }
+            }
+            return nullptr;
+        }
+
     private:
         // Members
         string name;
@@ -0,0 +1,280 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+using namespace std;
+
+// What Code Gen placed for the level that was kept (the image is empty if Code Gen had an error)
+struct Build
+{
+    string level;
+    bool overflowed = false;
+    vector<string> image;
+    int codeSize = 0;
+    int staticSize = 0;
+    int heapSize = 0;
+    vector<string> staticNames;
+    vector<string> staticTypes;
+    vector<Instruction> code;
+};
+
+// Runs the AST optimization passes and Code Gen for a program
+// If the program doesn't fit in memory, it starts over from the original AST with the next level of the size ladder
+class Optimizer
+{
+    public:
+        // Default constructor for the Optimizer class
+        Optimizer(const int progNum, Tree* progAST, SymbolTable* progSymTable, Options progOptions)
+        {
+            this->programNumber = progNum;
+            this->myAST = progAST;
+            this->mySymTable = progSymTable;
+            this->options = progOptions;
+        }
+
+        // Optimizes and generates code, trying smaller levels until the program fits
+        void compile()
+        {
+            // Levels to try: the one that was asked for, then every level of the ladder after it
+            vector<string> ladder = Options::sizeLadder();
+            vector<string> levels = {options.getLevel()};
+            auto found = find(ladder.begin(), ladder.end(), options.getLevel());
+            if (found == ladder.end())
+            {
+                levels.insert(levels.end(), ladder.begin(), ladder.end());
+            }
+            else
+            {
+                levels.insert(levels.end(), found + 1, ladder.end());
+            }
+
+            for (int i = 0, n = levels.size(); i < n; i++)
+            {
+                Options levelOptions = options;
+                levelOptions.setLevel(levels[i]);
+
+                bool last = i == n - 1;
+                if (attempt(levelOptions, last, i > 0))
+                {
+                    return;
+                }
+                if (!last)
+                {
+                    log("INFO", "Program #" + to_string(programNumber) + " doesn't fit in memory (or has a branch too far to reach) at -O" + levels[i] + ", trying again at -O" + levels[i + 1]);
+                }
+            }
+        }
+
+        // Getter for what Code Gen placed at the level that was kept
+        Build getBuild()
+        {
+            return this->build;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+        Tree* myAST;
+        SymbolTable* mySymTable;
+        Options options;
+
+        // Code Gen's results once a level generated the program without an error
+        Build build;
+
+        // Optimizes a copy of the AST and generates its code, returns false if it didn't fit in memory (and there are more levels to try)
+        bool attempt(Options& levelOptions, const bool last, const bool retried)
+        {
+            // Passes change the AST and Symbol Table, so the original is kept for the next level
+            Tree* ast = myAST->copy();
+            SymbolTable* symbolTable = mySymTable->copy();
+
+            // Passes are declared here since the Nodes they create point to their tokens, which Code Gen still needs
+            ConstantFolder folder = ConstantFolder(programNumber, ast, symbolTable);
+            if (levelOptions.isEnabled("fold"))
+            {
+                folder.fold();
+            }
+
+            // Propagating values can make more expressions constant (and folding can make more values known), so repeat until neither changes anything
+            ConstantPropagator propagator = ConstantPropagator(programNumber, ast, symbolTable);
+            if (levelOptions.isEnabled("propagate"))
+            {
+                bool changed = true;
+                while (changed)
+                {
+                    changed = propagator.propagate() > 0 && levelOptions.isEnabled("fold") && folder.fold() > 0;
+                }
+            }
+
+            // Remove stores and variables that nothing reads
+            DeadCodeEliminator eliminator = DeadCodeEliminator(programNumber, ast, symbolTable);
+            if (levelOptions.isEnabled("dce"))
+            {
+                eliminator.eliminate();
+            }
+
+            // Reuse values that were already computed instead of computing them again
+            CommonSubexpressions subexpressions = CommonSubexpressions(programNumber, ast, symbolTable);
+            if (levelOptions.isEnabled("cse") && subexpressions.eliminate() > 0)
+            {
+                // A value that was already assigned to a variable is now a copy of the new one, so the old variable can go
+                if (levelOptions.isEnabled("propagate"))
+                {
+                    propagator.propagate();
+                }
+                if (levelOptions.isEnabled("dce"))
+                {
+                    eliminator.eliminate();
+                }
+            }
+
+            // Compute values that don't change in a loop once before it
+            LoopInvariantMotion motion = LoopInvariantMotion(programNumber, ast, symbolTable);
+            int hoisted = 0;
+            if (levelOptions.isEnabled("licm"))
+            {
+                hoisted = motion.hoist();
+            }
+
+            // CODE GEN
+            CodeGen codeGen = CodeGen(programNumber, ast, symbolTable, levelOptions);
+            codeGen.generate();
+
+            // Every hoisted value takes a static byte, so the level is tried again without hoisting before going down the ladder
+            bool fits = !codeGen.canRetrySmaller();
+            bool withoutHoisting = !fits && hoisted > 0;
+            if (withoutHoisting)
+            {
+                log("INFO", "Program #" + to_string(programNumber) + " doesn't fit in memory with " + to_string(hoisted) + " value(s) hoisted out of loops at -O" + levelOptions.getLevel() + ", trying again without hoisting");
+            }
+            else if (fits || last)
+            {
+                codeGen.print();
+                build.overflowed = codeGen.hasOverflowed();
+                if (!codeGen.hasError())
+                {
+                    build.level = levelOptions.getLevel();
+                    build.image = codeGen.getImage();
+                    build.codeSize = codeGen.getCodeSize();
+                    build.staticSize = codeGen.getStaticSize();
+                    build.heapSize = codeGen.getHeapSize();
+                    build.staticNames = codeGen.getStaticNames();
+                    build.staticTypes = codeGen.getStaticTypes();
+
+                    // The Nodes go away with the copy of the AST, so the instructions are kept without them
+                    for (Instruction& instruction : codeGen.getCode())
+                    {
+                        build.code.emplace_back(instruction.getOpCode(), instruction.getOperand(), nullptr);
+                    }
+                }
+                if (fits && retried && !codeGen.hasError())
+                {
+                    log("INFO", "Program #" + to_string(programNumber) + " fits in memory at -O" + levelOptions.getLevel());
+                }
+                if (fits && !codeGen.hasError())
+                {
+                    log("INFO", "Program #" + to_string(programNumber) + " uses " + to_string(codeGen.getCodeSize()) + " code byte(s), " + to_string(codeGen.getStaticSize()) + " static byte(s), and " + to_string(codeGen.getHeapSize()) + " heap byte(s) of " + to_string(levelOptions.getTarget().getMemorySize()));
+                }
+
+                // Listing of what was placed, for reading the code instead of the hex
+                if (levelOptions.shouldList() && !codeGen.hasError())
+                {
+                    Listing listing = Listing(programNumber, codeGen, levelOptions.getTarget());
+                    listing.print();
+                }
+
+                // Map the code back to the source
+                if (levelOptions.getSourceMapPath() != "" && !codeGen.hasError())
+                {
+                    SourceMap sourceMap = SourceMap(programNumber, codeGen.getCode());
+                    sourceMap.write(levelOptions.getSourceMapPath());
+                }
+
+                // Run the image straight from Code Gen
+                bool profile = levelOptions.getProfilePath() != "";
+                if ((levelOptions.shouldRun() || profile) && !codeGen.hasError())
+                {
+                    Emulator emulator = Emulator(codeGen.getImage());
+                    emulator.setBudget(levelOptions.getStepBudget(), levelOptions.getCycleBudget());
+                    bool finished = emulator.run();
+                    emulator.printResults(programNumber, finished);
+
+                    // Cycles and bytes go back to the Nodes they were generated for
+                    if (profile)
+                    {
+                        Profiler profiler = Profiler(programNumber, codeGen.getCode(), emulator);
+                        profiler.printHotspots();
+                        profiler.writeCollapsedStacks(levelOptions.getProfilePath());
+                    }
+                }
+            }
+
+            deleteNode(ast->getRoot());
+            delete(ast);
+            deleteHashNode(symbolTable->getRoot());
+            delete(symbolTable);
+
+            if (withoutHoisting)
+            {
+                Options levelWithoutHoisting = levelOptions;
+                levelWithoutHoisting.setPass("licm", false);
+                return attempt(levelWithoutHoisting, last, true);
+            }
+            return fits || last;
+        }
+
+        // Deletes a copied AST by deleting its Nodes recursively
+        void deleteNode(Node* node)
+        {
+            if (node != nullptr)
+            {
+                for (Node* child : node->getChildren())
+                {
+                    deleteNode(child);
+                }
+                delete(node);
+            }
+        }
+
+        // Deletes a copied Symbol Table by deleting its HashNodes recursively
+        void deleteHashNode(HashNode* node)
+        {
+            if (node != nullptr)
+            {
+                for (HashNode* child : node->getChildren())
+                {
+                    deleteHashNode(child);
+                }
+                delete(node);
+            }
+        }
+
+        // Logging function for the optimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Optimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
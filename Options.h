@@ -0,0 +1,293 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+using namespace std;
+
+// Compiler options from the command line (target profile and which optimization passes run)
+class Options
+{
+    public:
+        // Default options (256 byte target with no optimizations)
+        Options()
+        {
+            setLevel("0");
+        }
+
+        // Sets the optimization level (0, 1, 2, s), returns false if it doesn't exist
+        bool setLevel(const string newLevel)
+        {
+            map<string, vector<string>> allLevels = levels();
+            if (allLevels.find(newLevel) == allLevels.end())
+            {
+                return false;
+            }
+
+            this->level = newLevel;
+            this->passes = set<string>(allLevels[newLevel].begin(), allLevels[newLevel].end());
+
+            // Passes turned on or off by themselves stay that way at every level
+            for (const auto& entry : overrides)
+            {
+                applyPass(entry.first, entry.second);
+            }
+            return true;
+        }
+
+        // Turns a single pass on or off, returns false if it doesn't exist
+        bool setPass(const string pass, const bool enabled)
+        {
+            vector<string> allPasses = passNames();
+            if (find(allPasses.begin(), allPasses.end(), pass) == allPasses.end())
+            {
+                return false;
+            }
+
+            this->overrides[pass] = enabled;
+            applyPass(pass, enabled);
+            return true;
+        }
+
+        // Forgets every pass turned on or off by itself, so the level decides all of them again
+        void clearPasses()
+        {
+            this->overrides.clear();
+            setLevel(this->level);
+        }
+
+        // Returns whether or not a pass should run
+        bool isEnabled(const string pass)
+        {
+            return this->passes.find(pass) != this->passes.end();
+        }
+
+        // Setter and getter for the target profile
+        void setTarget(Target newTarget)
+        {
+            this->target = newTarget;
+        }
+
+        Target getTarget()
+        {
+            return this->target;
+        }
+
+        // Getter for the optimization level
+        string getLevel()
+        {
+            return this->level;
+        }
+
+        // Setter and getter for running the program in the emulator after Code Gen
+        void setRun(const bool newRun)
+        {
+            this->run = newRun;
+        }
+
+        bool shouldRun()
+        {
+            return this->run;
+        }
+
+        // Setter and getter for printing an annotated listing of the generated code
+        void setListing(const bool newListing)
+        {
+            this->listing = newListing;
+        }
+
+        bool shouldList()
+        {
+            return this->listing;
+        }
+
+        // Setter and getter for going through the three-address IR in Code Gen (dumping it goes through it too)
+        void setIR(const bool newIR)
+        {
+            this->ir = newIR;
+        }
+
+        bool usesIR()
+        {
+            return this->ir || this->dumpIR;
+        }
+
+        // Setter and getter for printing the IR of each program
+        void setDumpIR(const bool newDumpIR)
+        {
+            this->dumpIR = newDumpIR;
+        }
+
+        bool shouldDumpIR()
+        {
+            return this->dumpIR;
+        }
+
+        // Setter and getter for what instruction selection on the IR path makes cheapest (size or speed), returns false if it isn't either
+        // Without one, -Os selects for size and every other level for speed
+        bool setCostModel(const string newModel)
+        {
+            if (newModel != "size" && newModel != "speed")
+            {
+                return false;
+            }
+            this->costModel = newModel;
+            return true;
+        }
+
+        string getCostModel()
+        {
+            if (this->costModel != "")
+            {
+                return this->costModel;
+            }
+            else if (this->level == "s")
+            {
+                return "size";
+            }
+            return "speed";
+        }
+
+        // Setter and getter for the file the profiler adds its collapsed stacks to ("" if it doesn't run)
+        void setProfilePath(const string newPath)
+        {
+            this->profilePath = newPath;
+        }
+
+        string getProfilePath()
+        {
+            return this->profilePath;
+        }
+
+        // Setter and getter for the file the source map is added to ("" if there isn't one)
+        void setSourceMapPath(const string newPath)
+        {
+            this->sourceMapPath = newPath;
+        }
+
+        string getSourceMapPath()
+        {
+            return this->sourceMapPath;
+        }
+
+        // Setter and getters for how long the emulator can run a program (0 steps is the emulator's default, and 0 cycles is no cap)
+        void setBudget(const long long newSteps, const long long newCycles)
+        {
+            this->stepBudget = newSteps;
+            this->cycleBudget = newCycles;
+        }
+
+        long long getStepBudget()
+        {
+            return this->stepBudget;
+        }
+
+        long long getCycleBudget()
+        {
+            return this->cycleBudget;
+        }
+
+        // Setter and getter for the report a batch run writes ("" if it isn't a batch)
+        void setBatchPath(const string newPath)
+        {
+            this->batchPath = newPath;
+        }
+
+        string getBatchPath()
+        {
+            return this->batchPath;
+        }
+
+        // Setter and getter for the report a differential run writes ("" if it isn't one)
+        void setDiffPath(const string newPath)
+        {
+            this->diffPath = newPath;
+        }
+
+        string getDiffPath()
+        {
+            return this->diffPath;
+        }
+
+        // Setter and getter for the header a superoptimizer run writes its rules to ("" if it isn't one)
+        void setSuperoptPath(const string newPath)
+        {
+            this->superoptPath = newPath;
+        }
+
+        string getSuperoptPath()
+        {
+            return this->superoptPath;
+        }
+
+        // Setter and getter for the number of workers a batch runs programs on (0 is one for every core)
+        void setJobs(const int newJobs)
+        {
+            this->jobs = newJobs;
+        }
+
+        int getJobs()
+        {
+            return this->jobs;
+        }
+
+        // Passes that run at each optimization level
+        static map<string, vector<string>> levels()
+        {
+            return {
+                {"0", {}},
+                {"1", {"fold", "propagate", "dce", "cse", "temps", "scratch", "registers", "branches", "rotate", "strength", "strings", "peephole"}},
+                {"2", {"fold", "propagate", "dce", "cse", "licm", "temps", "scratch", "registers", "branches", "rotate", "strength", "strings", "peephole"}},
+                {"s", {"fold", "propagate", "dce", "cse", "temps", "scratch", "registers", "branches", "rotate", "strength", "strings", "peephole"}}
+            };
+        }
+
+        // Every pass that can be turned on or off
+        static vector<string> passNames()
+        {
+            return {"fold", "propagate", "dce", "cse", "licm", "temps", "scratch", "registers", "branches", "rotate", "strength", "strings", "peephole"};
+        }
+
+        // Levels tried in order when a program doesn't fit in memory (each one makes smaller code than the last)
+        // -O1 isn't on it, since it runs the same passes as -Os and every one of them makes code smaller, but only -Os weighs
+        // choices like strength reduction and instruction selection by bytes
+        static vector<string> sizeLadder()
+        {
+            return {"s"};
+        }
+
+    private:
+        // Members
+        Target target;
+        string level;
+        set<string> passes;
+        bool run = false;
+        bool listing = false;
+        bool ir = false;
+        bool dumpIR = false;
+        string costModel = "";
+        string profilePath = "";
+        string sourceMapPath = "";
+        long long stepBudget = 0;
+        long long cycleBudget = 0;
+        string batchPath = "";
+        string diffPath = "";
+        string superoptPath = "";
+        int jobs = 0;
+
+        // Passes turned on or off from the command line
+        map<string, bool> overrides;
+
+        // Turns a pass on or off in the current set
+        void applyPass(const string pass, const bool enabled)
+        {
+            if (enabled)
+            {
+                this->passes.insert(pass);
+            }
+            else
+            {
+                this->passes.erase(pass);
+            }
+        }
+};
+
+#endif
\ No newline at end of file
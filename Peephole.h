@@ -0,0 +1,387 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+using namespace std;
+
+// Peephole optimizer that runs over the instructions from Code Gen before they are backpatched
+// Every rule only looks inside a basic block (labels, branches, and breaks end one)
+// The rules written by hand only ever remove instructions, and the superoptimized ones replace a window with a cheaper sequence (SuperRules.h)
+class Peephole
+{
+    public:
+        // Constructor for the Peephole optimizer
+        Peephole(vector<Instruction>& progCode) : code(progCode)
+        {
+        }
+
+        // Applies every rule until none of them change anything, returns how many bytes were saved
+        int optimize()
+        {
+            int sizeBefore = codeSize();
+
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                for (Rule& rule : rules)
+                {
+                    for (int i = 0; i < (int)code.size(); i++)
+                    {
+                        if ((this->*rule.apply)(i))
+                        {
+                            log("DEBUG", "Peephole: " + rule.name + " at instruction " + to_string(i));
+                            rule.count++;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+
+            int saved = sizeBefore - codeSize();
+            log("DEBUG", "Peephole: Saved " + to_string(saved) + " byte(s)");
+            return saved;
+        }
+
+    private:
+        // Instructions being optimized
+        vector<Instruction>& code;
+
+        // A rule tries to apply at an index, and returns whether or not it changed the code
+        struct Rule
+        {
+            string name;
+            bool (Peephole::*apply)(int);
+            int count;
+        };
+
+        // RULE TABLE (add a function below and a row here for a new rule)
+        vector<Rule> rules = {
+            {"Redundant load", &Peephole::redundantLoad, 0},
+            {"Redundant store", &Peephole::redundantStore, 0},
+            {"Dead store", &Peephole::deadStore, 0},
+            {"Dead load", &Peephole::deadLoad, 0},
+            {"Superoptimized", &Peephole::superoptimized, 0}
+        };
+
+        // Loads a register already holding the value (LDA Tn after STA Tn, LDX #01 after LDX #01, etc)
+        bool redundantLoad(int index)
+        {
+            string reg = loadedRegister(code[index]);
+            if (reg == "")
+            {
+                return false;
+            }
+            string operand = code[index].getOperand();
+            string mode = code[index].getMode();
+
+            // Walk back through the block to find what the register holds
+            for (int i = index - 1; i >= 0 && !endsBlock(code[i]); i--)
+            {
+                // Register was loaded with the same thing
+                if (loadedRegister(code[i]) == reg && code[i].getMode() == mode && code[i].getOperand() == operand)
+                {
+                    return remove(index);
+                }
+                // Accumulator was stored to the same location (store to load forwarding)
+                if (reg == "A" && mode == "absolute" && code[i].getMnemonic() == "STA" && code[i].getOperand() == operand)
+                {
+                    return remove(index);
+                }
+                // Anything that changes the register or the location stops the search
+                if (writesRegister(code[i], reg) || (mode == "absolute" && writesMemory(code[i], operand)))
+                {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        // Stores the accumulator where that value already is (STA Tn after LDA Tn or STA Tn)
+        bool redundantStore(int index)
+        {
+            if (code[index].getMnemonic() != "STA")
+            {
+                return false;
+            }
+            string operand = code[index].getOperand();
+
+            for (int i = index - 1; i >= 0 && !endsBlock(code[i]); i--)
+            {
+                string mnemonic = code[i].getMnemonic();
+                if ((mnemonic == "STA" || (mnemonic == "LDA" && code[i].getMode() == "absolute")) && code[i].getOperand() == operand)
+                {
+                    return remove(index);
+                }
+                if (writesRegister(code[i], "A") || writesMemory(code[i], operand))
+                {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        // Stores to a location that gets stored to again before anything reads it (like resetting the 0xFF scratch cell)
+        bool deadStore(int index)
+        {
+            if (code[index].getMnemonic() != "STA")
+            {
+                return false;
+            }
+            string operand = code[index].getOperand();
+
+            for (int i = index + 1, n = code.size(); i < n && !endsBlock(code[i]); i++)
+            {
+                if (readsMemory(i, operand))
+                {
+                    return false;
+                }
+                if (writesMemory(code[i], operand) && code[i].getMnemonic() == "STA")
+                {
+                    return remove(index);
+                }
+            }
+            return false;
+        }
+
+        // Loads a register that gets loaded again before anything reads it
+        bool deadLoad(int index)
+        {
+            // The first instruction always stays (loading the accumulator with 0 at the beginning of the program)
+            string reg = loadedRegister(code[index]);
+            if (index == 0 || reg == "")
+            {
+                return false;
+            }
+
+            for (int i = index + 1, n = code.size(); i < n && !endsBlock(code[i]); i++)
+            {
+                if (readsRegister(code[i], reg))
+                {
+                    return false;
+                }
+                if (writesRegister(code[i], reg))
+                {
+                    return remove(index);
+                }
+            }
+            return false;
+        }
+
+        // Replaces a window with the sequence the superoptimizer proved does the same thing for less
+        bool superoptimized(int index)
+        {
+            // The first instruction always stays
+            if (index == 0)
+            {
+                return false;
+            }
+
+            for (const SuperRule& rule : SUPER_RULES)
+            {
+                map<string, int> bound;
+                if (!matches(index, rule, bound))
+                {
+                    continue;
+                }
+
+                // Operands come from the instructions the placeholders matched, so strings keep their symbol
+                vector<Instruction> replacement;
+                for (const auto& op : rule.replacement)
+                {
+                    Instruction instruction = Instruction(op.first, op.second, code[index].getNode());
+                    if (bound.find(op.second) != bound.end())
+                    {
+                        instruction.setOperand(code[bound[op.second]].getOperand());
+                        instruction.setSymbol(code[bound[op.second]].getSymbol());
+                    }
+                    replacement.emplace_back(instruction);
+                }
+
+                code.erase(code.begin() + index, code.begin() + index + rule.window.size());
+                code.insert(code.begin() + index, replacement.begin(), replacement.end());
+                return true;
+            }
+            return false;
+        }
+
+        // Whether or not a rule's window matches the instructions at an index, binding each placeholder to the instruction it matched
+        // Different locations (m0, m1) have to be different operands, and none of them can be in the code (a label plus an offset)
+        bool matches(int index, const SuperRule& rule, map<string, int>& bound)
+        {
+            if (index + rule.window.size() > code.size())
+            {
+                return false;
+            }
+
+            set<string> locations;
+            for (int i = 0, n = rule.window.size(); i < n; i++)
+            {
+                Instruction& instruction = code[index + i];
+                string placeholder = rule.window[i].second;
+                if (endsBlock(instruction) || instruction.getOpCode() != rule.window[i].first)
+                {
+                    return false;
+                }
+
+                string operand = instruction.getOperand();
+                if (placeholder[0] == 'm' || placeholder[0] == 'k')
+                {
+                    if (bound.find(placeholder) != bound.end())
+                    {
+                        if (code[bound[placeholder]].getOperand() != operand)
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+                    if (placeholder[0] == 'm' && (operand[0] == 'L' || locations.count(operand)))
+                    {
+                        return false;
+                    }
+                    if (placeholder[0] == 'm')
+                    {
+                        locations.insert(operand);
+                    }
+                    bound[placeholder] = index + i;
+                }
+                else if (operand != placeholder)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Removes an instruction (always reports a change)
+        bool remove(int index)
+        {
+            code.erase(code.begin() + index);
+            return true;
+        }
+
+        // Labels can be jumped to and branches/breaks leave, so nothing is known across them
+        bool endsBlock(Instruction& instruction)
+        {
+            string mnemonic = instruction.getMnemonic();
+            return instruction.isLabel() || mnemonic == "BNE" || mnemonic == "BRK";
+        }
+
+        // Register a load instruction writes to ("" if it isn't a load)
+        string loadedRegister(Instruction& instruction)
+        {
+            string mnemonic = instruction.getMnemonic();
+            if (mnemonic == "LDA")
+            {
+                return "A";
+            }
+            else if (mnemonic == "LDX")
+            {
+                return "X";
+            }
+            else if (mnemonic == "LDY")
+            {
+                return "Y";
+            }
+            return "";
+        }
+
+        // Whether or not an instruction changes a register
+        bool writesRegister(Instruction& instruction, const string reg)
+        {
+            return loadedRegister(instruction) == reg || (reg == "A" && instruction.getMnemonic() == "ADC");
+        }
+
+        // Whether or not an instruction uses the value in a register
+        bool readsRegister(Instruction& instruction, const string reg)
+        {
+            string mnemonic = instruction.getMnemonic();
+            if (reg == "A")
+            {
+                return mnemonic == "STA" || mnemonic == "ADC";
+            }
+            else if (reg == "X")
+            {
+                return mnemonic == "CPX" || mnemonic == "SYS";
+            }
+            return mnemonic == "SYS";
+        }
+
+        // Whether or not an instruction changes a location in memory
+        bool writesMemory(Instruction& instruction, const string operand)
+        {
+            string mnemonic = instruction.getMnemonic();
+            return (mnemonic == "STA" || mnemonic == "INC") && instruction.getOperand() == operand;
+        }
+
+        // Whether or not the instruction at index could read a location in memory
+        bool readsMemory(int index, const string operand)
+        {
+            Instruction& instruction = code[index];
+            string mnemonic = instruction.getMnemonic();
+
+            // System calls read strings from memory unless they are printing an integer ($01 in X)
+            if (mnemonic == "SYS")
+            {
+                return knownX(index) != "01";
+            }
+            return instruction.getMode() == "absolute" && mnemonic != "STA" && instruction.getOperand() == operand;
+        }
+
+        // Finds the immediate value in the X register before an index ("" if it isn't known)
+        string knownX(int index)
+        {
+            for (int i = index - 1; i >= 0 && !endsBlock(code[i]); i--)
+            {
+                if (writesRegister(code[i], "X"))
+                {
+                    if (code[i].getMode() == "immediate")
+                    {
+                        return code[i].getOperand();
+                    }
+                    return "";
+                }
+            }
+            return "";
+        }
+
+        // Size of the code in bytes
+        int codeSize()
+        {
+            int size = 0;
+            for (Instruction& instruction : code)
+            {
+                size += instruction.getSize();
+            }
+            return size;
+        }
+
+        // Logging function for Peephole
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Code Gen - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+using namespace std;
+
+// Attributes the cycles an emulator run spent (and the code bytes) back to the AST Nodes and source positions they were generated for
+// Statements are ranked in a hotspot report, and every Node's stack of parents is written in the collapsed format flame graph tools read
+class Profiler
+{
+    public:
+        // Default constructor for the Profiler class (code is what Code Gen placed, emulator is what ran it)
+        Profiler(const int progNum, vector<Instruction> progCode, Emulator& emulator)
+        {
+            this->programNumber = progNum;
+
+            vector<long long> addressCycles = emulator.getAddressCycles();
+            vector<long long> addressCounts = emulator.getAddressCounts();
+
+            for (Instruction& instruction : progCode)
+            {
+                if (instruction.isLabel())
+                {
+                    continue;
+                }
+
+                Node* node = instruction.getNode();
+                long long cycles = addressCycles[instruction.getAddress()];
+                totalCycles += cycles;
+                totalBytes += instruction.getSize();
+
+                // Statement the instruction belongs to (in the order statements first show up)
+                Node* statement = statementOf(node);
+                if (hotspots.find(statement) == hotspots.end())
+                {
+                    int order = hotspots.size();
+                    hotspots[statement] = Hotspot(order);
+                }
+                Hotspot& hotspot = hotspots[statement];
+                hotspot.cycles += cycles;
+                hotspot.bytes += instruction.getSize();
+                hotspot.runs = max(hotspot.runs, addressCounts[instruction.getAddress()]);
+
+                stacks[stackOf(node)] += cycles;
+            }
+        }
+
+        // Logs every statement from the most cycles to the fewest (ties go to the one with more bytes)
+        void printHotspots()
+        {
+            vector<pair<Node*, Hotspot>> ranked(hotspots.begin(), hotspots.end());
+            sort(ranked.begin(), ranked.end(), [](const pair<Node*, Hotspot>& a, const pair<Node*, Hotspot>& b)
+            {
+                if (a.second.cycles != b.second.cycles)
+                {
+                    return a.second.cycles > b.second.cycles;
+                }
+                if (a.second.bytes != b.second.bytes)
+                {
+                    return a.second.bytes > b.second.bytes;
+                }
+                return a.second.order < b.second.order;
+            });
+
+            log("INFO", "Hotspots for Program #" + to_string(programNumber) + " (" + to_string(totalCycles) + " cycle(s), " + to_string(totalBytes) + " code byte(s))");
+            log("INFO", column("CYCLES", 10) + column("%", 8) + column("RUNS", 8) + column("BYTES", 8) + "STATEMENT");
+            for (auto& entry : ranked)
+            {
+                Hotspot& hotspot = entry.second;
+
+                // Percent of the cycles with a single decimal
+                stringstream percent;
+                percent << fixed << setprecision(1);
+                if (totalCycles > 0)
+                {
+                    percent << 100.0 * hotspot.cycles / totalCycles;
+                }
+                else
+                {
+                    percent << 0.0;
+                }
+
+                log("INFO", column(to_string(hotspot.cycles), 10) + column(percent.str(), 8) + column(to_string(hotspot.runs), 8) + column(to_string(hotspot.bytes), 8) + describe(entry.first));
+            }
+        }
+
+        // Adds a line for every stack of Nodes (frames split by ;) and the cycles spent in it to a file, returns false if it couldn't be written
+        bool writeCollapsedStacks(const string path)
+        {
+            ofstream file(path, ios::app);
+            if (!file)
+            {
+                log("ERROR", "Could not write the profile to " + path);
+                return false;
+            }
+
+            for (const auto& entry : stacks)
+            {
+                file << entry.first << " " << entry.second << endl;
+            }
+            log("INFO", "Collapsed stacks for Program #" + to_string(programNumber) + " added to " + path);
+            return true;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+
+        // What a statement cost: cycles spent, most times one of its instructions ran, and code bytes
+        struct Hotspot
+        {
+            int order;
+            long long cycles;
+            long long runs;
+            int bytes;
+
+            // Constructor for struct
+            Hotspot(const int o = 0)
+            {
+                order = o;
+                cycles = 0;
+                runs = 0;
+                bytes = 0;
+            }
+        };
+
+        // Every statement (nullptr for the code around the program, like its final break), and cycles for every stack
+        unordered_map<Node*, Hotspot> hotspots;
+        map<string, long long> stacks;
+
+        long long totalCycles = 0;
+        int totalBytes = 0;
+
+        // The statement a Node is part of (the child of a Block it is under)
+        Node* statementOf(Node* node)
+        {
+            while (node && node->getParent() && node->getParent()->getName() != "Block")
+            {
+                node = node->getParent();
+            }
+            return node;
+        }
+
+        // Frames from the program down to a Node
+        string stackOf(Node* node)
+        {
+            string stack = "";
+            while (node)
+            {
+                stack = frame(node) + ";" + stack;
+                node = node->getParent();
+            }
+            stack = "Program#" + to_string(programNumber) + ";" + stack;
+
+            // No trailing separator
+            stack.pop_back();
+            return stack;
+        }
+
+        // Name of a Node in a stack (leaves are in brackets like in the AST)
+        string frame(Node* node)
+        {
+            string name = node->getName();
+            if (node->isLeaf())
+            {
+                name = "[" + name + "]";
+            }
+            return name + "@" + location(node);
+        }
+
+        // Name and position of a statement for the report
+        string describe(Node* node)
+        {
+            if (!node)
+            {
+                return "Program start/end";
+            }
+            return node->getName() + " at (" + location(node) + ")";
+        }
+
+        // Line and column of a Node (the first token under it if it doesn't have one, like Assign and Print)
+        string location(Node* node)
+        {
+            Token* token = node->getFirstToken();
+            if (!token)
+            {
+                return "?";
+            }
+            return to_string(token->getLine()) + ":" + to_string(token->getColumn());
+        }
+
+        // Pads a value to a column width
+        string column(const string value, const int width)
+        {
+            string padded = value;
+            while ((int)padded.length() < width)
+            {
+                padded += " ";
+            }
+            return padded;
+        }
+
+        // Logging function for the profiler
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Profiler - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef REGISTERSTATE_H
+#define REGISTERSTATE_H
+
+using namespace std;
+
+// Keeps track of what the A, X, and Y registers hold while Code Gen emits instructions
+// A value is either an immediate (#01) or the contents of an address (T0, 00FF), and a register can hold several that are equal
+class RegisterState
+{
+    public:
+        // Nothing is known at first
+        RegisterState()
+        {
+            clear();
+        }
+
+        // Forgets everything (like at the top of a loop, which can be jumped back to)
+        void clear()
+        {
+            this->values = {{"A", {}}, {"X", {}}, {"Y", {}}};
+        }
+
+        // Returns whether or not a load would put a value in a register that is already there
+        bool holds(Instruction& instruction)
+        {
+            string reg = loadedRegister(instruction);
+            if (reg == "")
+            {
+                return false;
+            }
+            return this->values[reg].count(loadedValue(instruction)) > 0;
+        }
+
+        // Updates the registers after an instruction runs
+        void update(Instruction& instruction)
+        {
+            string mnemonic = instruction.getMnemonic();
+            string operand = instruction.getOperand();
+            string reg = loadedRegister(instruction);
+
+            // Loads replace what the register held
+            if (reg != "")
+            {
+                this->values[reg] = {loadedValue(instruction)};
+            }
+            // Stores change the location, so only the accumulator holds its new contents
+            else if (mnemonic == "STA")
+            {
+                forgetAddress(operand);
+                this->values["A"].insert(operand);
+            }
+            // Adding changes the accumulator
+            else if (mnemonic == "ADC")
+            {
+                this->values["A"].clear();
+            }
+            // Incrementing changes the location
+            else if (mnemonic == "INC")
+            {
+                forgetAddress(operand);
+            }
+        }
+
+        // Keeps only what is known the same way in both states (where two paths meet at a label)
+        void merge(RegisterState& other)
+        {
+            for (auto& entry : this->values)
+            {
+                set<string>& otherValues = other.values[entry.first];
+                for (auto it = entry.second.begin(); it != entry.second.end();)
+                {
+                    if (otherValues.count(*it) == 0)
+                    {
+                        it = entry.second.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+            }
+        }
+
+    private:
+        // What each register holds
+        map<string, set<string>> values;
+
+        // Register a load instruction writes to ("" if it isn't a load)
+        string loadedRegister(Instruction& instruction)
+        {
+            string mnemonic = instruction.getMnemonic();
+            if (mnemonic == "LDA")
+            {
+                return "A";
+            }
+            else if (mnemonic == "LDX")
+            {
+                return "X";
+            }
+            else if (mnemonic == "LDY")
+            {
+                return "Y";
+            }
+            return "";
+        }
+
+        // Value a load puts in its register
+        string loadedValue(Instruction& instruction)
+        {
+            if (instruction.getMode() == "immediate")
+            {
+                return "#" + instruction.getOperand();
+            }
+            return instruction.getOperand();
+        }
+
+        // Forgets that any register holds the contents of an address
+        void forgetAddress(const string address)
+        {
+            for (auto& entry : this->values)
+            {
+                entry.second.erase(address);
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef SELECTIONRULES_H
+#define SELECTIONRULES_H
+
+using namespace std;
+
+// Nonterminals a tree can be reduced to: an immediate operand, a memory operand, a value in A, X, or Y,
+// or the Z flag after a compare (set if the value is true for Z, or if it is false for NZ)
+enum Nonterminal { IMM, MEM, REG_A, REG_X, REG_Y, FLAG_Z, FLAG_NZ, NONTERMINAL_COUNT };
+
+const vector<string> NONTERMINAL_NAMES = {"imm", "mem", "a", "x", "y", "z", "nz"};
+
+// A tree pattern and the instructions that cover it
+// Chain rules (no op) turn the left nonterminal into the result, and operator rules (add, eq, ne) match a node whose children
+// reduce to the left and right nonterminals (either way around, since they are all commutative)
+// The cost of a rule is the size or cycles of its op codes in OP_CODES
+struct TreeRule
+{
+    Nonterminal result;
+    string op;
+    Nonterminal left;
+    Nonterminal right;
+    vector<string> opCodes;
+};
+
+const vector<TreeRule> TREE_RULES = {
+    // Loads: LDA, LDX, LDY from an immediate or memory
+    {REG_A, "", IMM, IMM, {"A9"}},
+    {REG_A, "", MEM, MEM, {"AD"}},
+    {REG_X, "", IMM, IMM, {"A2"}},
+    {REG_X, "", MEM, MEM, {"AE"}},
+    {REG_Y, "", IMM, IMM, {"A0"}},
+    {REG_Y, "", MEM, MEM, {"AC"}},
+
+    // Spill A to a temp slot: STA
+    {MEM, "", REG_A, REG_A, {"8D"}},
+
+    // Turn the Z flag into 0 or 1: LDA #00/#01, BNE over, LDA #01/#00
+    {REG_A, "", FLAG_Z, FLAG_Z, {"A9", "D0", "A9"}},
+    {REG_A, "", FLAG_NZ, FLAG_NZ, {"A9", "D0", "A9"}},
+
+    // ADC adds memory to A, and CPX compares X to memory
+    {REG_A, "add", REG_A, MEM, {"6D"}},
+    {FLAG_Z, "eq", REG_X, MEM, {"EC"}},
+    {FLAG_NZ, "ne", REG_X, MEM, {"EC"}}
+};
+
+// How a node reaches a nonterminal when it isn't through a rule in TREE_RULES
+const int LEAF = -2;
+const int FOLD = -3;
+const int RETEST = -4;
+
+// An expression tree rebuilt from the IR (temps read once are replaced by the instruction that wrote them)
+// Labeling fills in the cheapest way to reduce it to every nonterminal
+struct IRTree
+{
+    // add, eq, ne, or leaf (value is a constant, variable, temp, or string)
+    string op;
+    IRValue value;
+    int left;
+    int right;
+    Node* node;
+
+    // Whether or not the value is known while compiling (a constant, or folded from constants), and what it is
+    bool isConstant = false;
+    int constant = 0;
+
+    // Cheapest cost for each nonterminal, and how it is reached: a rule in TREE_RULES (with the children swapped or not),
+    // LEAF, FOLD, or RETEST (the Z flag of a compare the node tests against 0 or 1, from the child it names)
+    long long costs[NONTERMINAL_COUNT];
+    int rules[NONTERMINAL_COUNT];
+    bool swapped[NONTERMINAL_COUNT];
+    Nonterminal from[NONTERMINAL_COUNT];
+
+    // Operand once reduced to IMM or MEM, and the temp slot it was spilled to ("" if it wasn't)
+    string operand = "";
+    string spill = "";
+
+    // Constructor for struct
+    IRTree(const string o, const IRValue v, const int l, const int r, Node* n)
+    {
+        op = o;
+        value = v;
+        left = l;
+        right = r;
+        node = n;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef SOURCEMAP_H
+#define SOURCEMAP_H
+
+using namespace std;
+
+// Maps the addresses of the generated code back to the AST Nodes and source positions they were generated for
+// Written as a side file with a line for every run of instructions from the same Node:
+//   program start end node line:column   (start and end are hex addresses, end is the first address after the run)
+class SourceMap
+{
+    public:
+        // Default constructor for the SourceMap class (code is what Code Gen placed)
+        SourceMap(const int progNum, vector<Instruction> progCode)
+        {
+            this->programNumber = progNum;
+
+            for (Instruction& instruction : progCode)
+            {
+                if (instruction.isLabel() || instruction.getSize() == 0)
+                {
+                    continue;
+                }
+
+                // Instructions that come one after another from the same Node share an entry
+                Node* node = instruction.getNode();
+                int address = instruction.getAddress();
+                if (!entries.empty() && entries.back().node == node && entries.back().end == address)
+                {
+                    entries.back().end += instruction.getSize();
+                }
+                else
+                {
+                    entries.emplace_back(node, address, address + instruction.getSize());
+                }
+            }
+        }
+
+        // Adds the map of this program to a file (with a header if the file is new), returns false if it couldn't be written
+        bool write(const string path)
+        {
+            // The header only goes at the top of the file
+            ifstream existing(path);
+            bool isNew = !existing || existing.peek() == EOF;
+            existing.close();
+
+            ofstream file(path, ios::app);
+            if (!file)
+            {
+                log("ERROR", "Could not write the source map to " + path);
+                return false;
+            }
+
+            if (isNew)
+            {
+                file << "# program start end node line:column" << endl;
+            }
+
+            for (Entry& entry : entries)
+            {
+                file << programNumber << " " << toAddress(entry.start) << " " << toAddress(entry.end) << " " << kind(entry.node) << " " << location(entry.node) << endl;
+            }
+            log("INFO", "Source map for Program #" + to_string(programNumber) + " added to " + path + " (" + to_string(entries.size()) + " entry(s))");
+            return true;
+        }
+
+    private:
+        // Default members
+        int programNumber;
+
+        // A run of code from a single Node
+        struct Entry
+        {
+            Node* node;
+            int start;
+            int end;
+
+            // Constructor for struct
+            Entry(Node* n, const int s, const int e)
+            {
+                node = n;
+                start = s;
+                end = e;
+            }
+        };
+
+        vector<Entry> entries;
+
+        // Kind of a Node (leaves go by their token type, and code that isn't from a Node belongs to the program)
+        string kind(Node* node)
+        {
+            if (!node)
+            {
+                return "Program";
+            }
+            else if (node->isLeaf() && node->isTokenLinked())
+            {
+                return node->getToken()->getType();
+            }
+            return node->getName();
+        }
+
+        // Line and column of a Node (the first token under it if it doesn't have one, like Assign and Print)
+        string location(Node* node)
+        {
+            Token* token = nullptr;
+            if (node)
+            {
+                token = node->getFirstToken();
+            }
+            if (!token)
+            {
+                return "0:0";
+            }
+            return to_string(token->getLine()) + ":" + to_string(token->getColumn());
+        }
+
+        // Convert an address to 4 digit hexadecimal
+        string toAddress(const int address)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(4) << setfill('0') << address;
+            return result.str();
+        }
+
+        // Logging function for the source map
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Source Map - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef SUPERRULES_H
+#define SUPERRULES_H
+
+using namespace std;
+
+// GENERATED by the superoptimizer (make superopt), do not edit
+// Operands are m0, m1, etc for different locations in memory, k0, k1, etc for any immediate value, or hex for just that value
+// Each replacement leaves the registers, the Z flag, and every location the same as the window it replaces
+struct SuperRule
+{
+    vector<pair<string, string>> window;
+    vector<pair<string, string>> replacement;
+};
+
+// Most bytes saved across the programs the rules were found in first
+const vector<SuperRule> SUPER_RULES = {
+    // STA m0, LDA #k0, STA m0 -> LDA #k0, STA m0 (saves 3 byte(s) and 4 cycle(s), proven over 65536 state(s))
+    {{{"8D", "m0"}, {"A9", "k0"}, {"8D", "m0"}}, {{"A9", "k0"}, {"8D", "m0"}}},
+    // LDA #k0, STA m0, LDA #k0 -> LDA #k0, STA m0 (saves 2 byte(s) and 2 cycle(s), proven over 256 state(s))
+    {{{"A9", "k0"}, {"8D", "m0"}, {"A9", "k0"}}, {{"A9", "k0"}, {"8D", "m0"}}},
+    // STA m0, STA m1, STA m0 -> STA m0, STA m1 (saves 3 byte(s) and 4 cycle(s), proven over 256 state(s))
+    {{{"8D", "m0"}, {"8D", "m1"}, {"8D", "m0"}}, {{"8D", "m0"}, {"8D", "m1"}}},
+    // STA m0, STA m0 -> STA m0 (saves 3 byte(s) and 4 cycle(s), proven over 256 state(s))
+    {{{"8D", "m0"}, {"8D", "m0"}}, {{"8D", "m0"}}},
+    // LDA #01, ADC m0, STA m0 -> INC m0, LDA m0 (saves 2 byte(s) and 0 cycle(s), proven over 256 state(s))
+    {{{"A9", "01"}, {"6D", "m0"}, {"8D", "m0"}}, {{"EE", "m0"}, {"AD", "m0"}}},
+    // STA m0, LDA m0 -> STA m0 (saves 3 byte(s) and 4 cycle(s), proven over 256 state(s))
+    {{{"8D", "m0"}, {"AD", "m0"}}, {{"8D", "m0"}}},
+    // LDA #k0, STA m0, LDY m0 -> LDA #k0, LDY #k0, STA m0 (saves 1 byte(s) and 2 cycle(s), proven over 256 state(s))
+    {{{"A9", "k0"}, {"8D", "m0"}, {"AC", "m0"}}, {{"A9", "k0"}, {"A0", "k0"}, {"8D", "m0"}}},
+    // LDA #00, ADC m0 -> LDA m0 (saves 2 byte(s) and 2 cycle(s), proven over 256 state(s))
+    {{{"A9", "00"}, {"6D", "m0"}}, {{"AD", "m0"}}}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,719 @@
+#ifndef SUPEROPTIMIZER_H
+#define SUPEROPTIMIZER_H
+
+using namespace std;
+
+// Offline superoptimizer for the short sequences of instructions Code Gen leaves behind
+// Every window of instructions inside a basic block is counted across the programs it is given, then for the most common ones
+// every cheaper sequence over the instruction subset is tried, shortest first
+// A sequence only replaces a window if emulating both gives the same registers, Z flag, and memory for every combination
+// of the values the two of them depend on, so the replacements are proven and not just tested
+// The replacements are written as a header of rules the peephole optimizer applies (SuperRules.h)
+class Superoptimizer
+{
+    public:
+        // Default constructor for the Superoptimizer class (windows used fewer times than minUses are left alone)
+        Superoptimizer(const int minUses)
+        {
+            this->minimumUses = minUses;
+        }
+
+        // Counts every window in the code Code Gen placed for a program
+        void add(vector<Instruction> code)
+        {
+            // The first instruction always stays (loading the accumulator with 0 at the beginning of the program)
+            for (int start = 1, n = code.size(); start < n; start++)
+            {
+                vector<Op> window;
+                map<string, int> locations;
+                for (int i = start; i < n && i - start < MAX_WINDOW; i++)
+                {
+                    Op op;
+                    if (!toOp(code[i], locations, op))
+                    {
+                        break;
+                    }
+                    window.emplace_back(op);
+
+                    if (window.size() >= 2)
+                    {
+                        // Counted as it is and with its immediate values left open, since a rule for any value covers more code
+                        windows[key(window)].uses++;
+                        windows[key(window)].ops = window;
+                        vector<Op> open = openImmediates(window);
+                        windows[key(open)].uses++;
+                        windows[key(open)].ops = open;
+                    }
+                }
+            }
+        }
+
+        // Searches for a replacement for every window used enough, shortest windows first
+        // A window is skipped if a rule already covers part of it, since the peephole optimizer would apply that one first
+        void search()
+        {
+            auto start = chrono::steady_clock::now();
+
+            for (int length = 2; length <= MAX_WINDOW; length++)
+            {
+                // Open windows go before the ones with values so the more general rule wins
+                for (int open = 1; open >= 0; open--)
+                {
+                    for (auto& entry : windows)
+                    {
+                        Window& window = entry.second;
+                        if ((int)window.ops.size() != length || window.uses < minimumUses || hasImmediates(window.ops) == (bool)open || isCovered(window.ops))
+                        {
+                            continue;
+                        }
+
+                        searched++;
+                        if (findReplacement(window))
+                        {
+                            rules.emplace_back(window);
+                            ruleKeys.insert(entry.first);
+                            log("DEBUG", "Found " + describe(window.ops) + " -> " + describe(window.replacement) + " (" + to_string(window.uses) + " use(s))");
+                        }
+                    }
+                }
+            }
+
+            // Most bytes saved across the programs first
+            stable_sort(rules.begin(), rules.end(), [this](const Window& a, const Window& b)
+            {
+                return a.uses * (bytes(a.ops) - bytes(a.replacement)) > b.uses * (bytes(b.ops) - bytes(b.replacement));
+            });
+
+            auto end = chrono::steady_clock::now();
+            milliseconds = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        }
+
+        // Logs what was found
+        void printSummary()
+        {
+            log("INFO", "Searched " + to_string(searched) + " of " + to_string(windows.size()) + " window(s) in " + to_string(milliseconds) + " ms, found " + to_string(rules.size()) + " rule(s)");
+            for (Window& rule : rules)
+            {
+                log("INFO", describe(rule.ops) + " -> " + describe(rule.replacement) + ": " + to_string(rule.uses) + " use(s), saves " + to_string(bytes(rule.ops) - bytes(rule.replacement)) + " byte(s) and " + to_string(cycles(rule.ops) - cycles(rule.replacement)) + " cycle(s), proven over " + to_string(rule.states) + " state(s)");
+            }
+        }
+
+        // Writes the rules as a header, returns false if it couldn't be written
+        bool writeHeader(const string path)
+        {
+            ofstream file(path);
+            if (!file)
+            {
+                log("ERROR", "Could not write the rules to " + path);
+                return false;
+            }
+
+            file << "#ifndef SUPERRULES_H" << endl;
+            file << "#define SUPERRULES_H" << endl;
+            file << endl;
+            file << "using namespace std;" << endl;
+            file << endl;
+            file << "// GENERATED by the superoptimizer (make superopt), do not edit" << endl;
+            file << "// Operands are m0, m1, etc for different locations in memory, k0, k1, etc for any immediate value, or hex for just that value" << endl;
+            file << "// Each replacement leaves the registers, the Z flag, and every location the same as the window it replaces" << endl;
+            file << "struct SuperRule" << endl;
+            file << "{" << endl;
+            file << "    vector<pair<string, string>> window;" << endl;
+            file << "    vector<pair<string, string>> replacement;" << endl;
+            file << "};" << endl;
+            file << endl;
+            file << "// Most bytes saved across the programs the rules were found in first" << endl;
+            file << "const vector<SuperRule> SUPER_RULES = {" << endl;
+            for (int i = 0, n = rules.size(); i < n; i++)
+            {
+                Window& rule = rules[i];
+                file << "    // " << describe(rule.ops) << " -> " << describe(rule.replacement) << " (saves " << bytes(rule.ops) - bytes(rule.replacement) << " byte(s) and " << cycles(rule.ops) - cycles(rule.replacement) << " cycle(s), proven over " << rule.states << " state(s))" << endl;
+                file << "    {" << initializer(rule.ops) << ", " << initializer(rule.replacement) << "}";
+                if (i < n - 1)
+                {
+                    file << ",";
+                }
+                file << endl;
+            }
+            file << "};" << endl;
+            file << endl;
+            file << "#endif";
+
+            log("INFO", "Rules written to " + path);
+            return true;
+        }
+
+    private:
+        // Longest window looked at, and longest sequence tried in place of one
+        static const int MAX_WINDOW = 4;
+        static const int MAX_REPLACEMENT = 3;
+
+        // Most bytes of input a replacement can be proven over (every combination of them is emulated)
+        static const int MAX_INPUT_BYTES = 3;
+
+        // Random states a replacement has to match before it is worth proving
+        static const int SAMPLES = 64;
+
+        // What the emulated state holds: the registers, the Z flag, a location for each m, and a value for each k
+        static const int A = 0;
+        static const int X = 1;
+        static const int Y = 2;
+        static const int Z = 3;
+        static const int MEMORY = 4;
+        static const int IMMEDIATES = MEMORY + MAX_WINDOW;
+        static const int STATE_SIZE = IMMEDIATES + MAX_WINDOW;
+
+        // An instruction with its operand as a placeholder
+        struct Op
+        {
+            int opCode;
+            // 'm' for a location, 'k' for an immediate value, or '#' for an immediate that has to be this value
+            char kind;
+            int value;
+        };
+
+        // A window of instructions, how many times it was found, and the replacement that was proven for it
+        struct Window
+        {
+            vector<Op> ops;
+            int uses = 0;
+            vector<Op> replacement;
+            long long states = 0;
+        };
+
+        // Default members
+        int minimumUses;
+        map<string, Window> windows;
+        vector<Window> rules;
+        set<string> ruleKeys;
+        int searched = 0;
+        long long milliseconds = 0;
+
+        // Turns an instruction into an op, returns false if it can't be part of a window
+        // Labels, branches, breaks, and system calls end one, and so do stores into the code (a label plus an offset)
+        bool toOp(Instruction& instruction, map<string, int>& locations, Op& op)
+        {
+            string mnemonic = instruction.getMnemonic();
+            if (instruction.isLabel() || mnemonic == "BNE" || mnemonic == "BRK" || mnemonic == "SYS" || mnemonic == "NOP")
+            {
+                return false;
+            }
+
+            op.opCode = stoi(instruction.getOpCode(), nullptr, 16);
+            if (instruction.getMode() == "immediate")
+            {
+                op.kind = '#';
+                op.value = stoi(instruction.getOperand(), nullptr, 16);
+                return true;
+            }
+
+            string operand = instruction.getOperand();
+            if (operand[0] == 'L')
+            {
+                return false;
+            }
+            if (locations.find(operand) == locations.end())
+            {
+                int next = locations.size();
+                locations[operand] = next;
+            }
+            op.kind = 'm';
+            op.value = locations[operand];
+            return true;
+        }
+
+        // The same window with a placeholder for each immediate value (the same value gets the same one)
+        vector<Op> openImmediates(vector<Op> ops)
+        {
+            map<int, int> placeholders;
+            for (Op& op : ops)
+            {
+                if (op.kind == '#')
+                {
+                    if (placeholders.find(op.value) == placeholders.end())
+                    {
+                        int next = placeholders.size();
+                        placeholders[op.value] = next;
+                    }
+                    op.kind = 'k';
+                    op.value = placeholders[op.value];
+                }
+            }
+            return ops;
+        }
+
+        // Whether or not a window still has an immediate that has to be a certain value
+        bool hasImmediates(const vector<Op>& ops)
+        {
+            for (const Op& op : ops)
+            {
+                if (op.kind == '#')
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // The same window with placeholders numbered from 0 in the order they show up (for a part of a bigger one)
+        vector<Op> renumber(vector<Op> ops)
+        {
+            map<pair<char, int>, int> numbers;
+            map<char, int> next;
+            for (Op& op : ops)
+            {
+                if (op.kind == '#')
+                {
+                    continue;
+                }
+                auto placeholder = make_pair(op.kind, op.value);
+                if (numbers.find(placeholder) == numbers.end())
+                {
+                    numbers[placeholder] = next[op.kind]++;
+                }
+                op.value = numbers[placeholder];
+            }
+            return ops;
+        }
+
+        // Whether or not a rule was already found for a part of a window (or for it with its immediates left open)
+        bool isCovered(const vector<Op>& ops)
+        {
+            int n = ops.size();
+            for (int start = 0; start < n; start++)
+            {
+                for (int end = start + 2; end <= n; end++)
+                {
+                    vector<Op> part = renumber(vector<Op>(ops.begin() + start, ops.begin() + end));
+                    if (ruleKeys.count(key(part)) || ruleKeys.count(key(openImmediates(part))))
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Searches every sequence cheaper than a window for one that is proven to do the same thing, keeps the cheapest
+        bool findReplacement(Window& window)
+        {
+            // Instructions a replacement can be made of: anything on the locations in the window, and loads of its immediates, 0, or 1
+            vector<Op> alphabet;
+            set<pair<char, int>> immediates = {{'#', 0}, {'#', 1}};
+            int locationCount = 0;
+            for (Op& op : window.ops)
+            {
+                if (op.kind == 'm')
+                {
+                    locationCount = max(locationCount, op.value + 1);
+                }
+                else
+                {
+                    immediates.insert({op.kind, op.value});
+                }
+            }
+            for (const auto& immediate : immediates)
+            {
+                for (int opCode : {0xA9, 0xA2, 0xA0})
+                {
+                    alphabet.push_back({opCode, immediate.first, immediate.second});
+                }
+            }
+            for (int location = 0; location < locationCount; location++)
+            {
+                for (int opCode : {0xAD, 0xAE, 0xAC, 0x8D, 0x6D, 0xEC, 0xEE})
+                {
+                    alphabet.push_back({opCode, 'm', location});
+                }
+            }
+
+            // What the window does to random states, so most sequences can be thrown out without proving anything
+            mt19937 random(SAMPLES);
+            vector<array<int, STATE_SIZE>> samples;
+            vector<array<int, STATE_SIZE>> expected;
+            for (int i = 0; i < SAMPLES; i++)
+            {
+                array<int, STATE_SIZE> state;
+                for (int& value : state)
+                {
+                    value = random() % 0x100;
+                }
+                state[Z] = random() % 2;
+                samples.emplace_back(state);
+                execute(window.ops, state);
+                expected.emplace_back(state);
+            }
+
+            vector<Op> candidate;
+            int bestBytes = bytes(window.ops);
+            int bestCycles = cycles(window.ops);
+            bool found = false;
+            int longest = window.ops.size();
+            if (longest > MAX_REPLACEMENT)
+            {
+                longest = MAX_REPLACEMENT;
+            }
+            tryCandidates(window, alphabet, samples, expected, candidate, longest, bestBytes, bestCycles, found);
+            return found;
+        }
+
+        // Tries every sequence that starts with candidate, keeping the cheapest proven one in the window
+        // A sequence has to cost no more bytes and no more cycles than the best so far, and less of one of them
+        void tryCandidates(Window& window, vector<Op>& alphabet, vector<array<int, STATE_SIZE>>& samples, vector<array<int, STATE_SIZE>>& expected,
+                           vector<Op>& candidate, const int longest, int& bestBytes, int& bestCycles, bool& found)
+        {
+            int candidateBytes = bytes(candidate);
+            int candidateCycles = cycles(candidate);
+            if (candidateBytes > bestBytes || candidateCycles > bestCycles)
+            {
+                return;
+            }
+
+            if (candidateBytes < bestBytes || candidateCycles < bestCycles)
+            {
+                long long states = 0;
+                if (matchesSamples(candidate, samples, expected) && prove(window.ops, candidate, states))
+                {
+                    window.replacement = candidate;
+                    window.states = states;
+                    bestBytes = candidateBytes;
+                    bestCycles = candidateCycles;
+                    found = true;
+                }
+            }
+
+            if ((int)candidate.size() >= longest)
+            {
+                return;
+            }
+            for (Op& op : alphabet)
+            {
+                candidate.emplace_back(op);
+                tryCandidates(window, alphabet, samples, expected, candidate, longest, bestBytes, bestCycles, found);
+                candidate.pop_back();
+            }
+        }
+
+        // Whether or not a sequence does the same thing as the window to every random state
+        bool matchesSamples(const vector<Op>& candidate, vector<array<int, STATE_SIZE>>& samples, vector<array<int, STATE_SIZE>>& expected)
+        {
+            for (int i = 0, n = samples.size(); i < n; i++)
+            {
+                array<int, STATE_SIZE> state = samples[i];
+                execute(candidate, state);
+                if (state != expected[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Emulates both sequences for every combination of the values they depend on, returns false if any of them differ
+        // or there are too many to try (states is how many there were)
+        // A value matters if either sequence reads it before writing it, or only one of them writes it
+        bool prove(const vector<Op>& window, const vector<Op>& candidate, long long& states)
+        {
+            vector<bool> windowReads;
+            vector<bool> windowWrites;
+            vector<bool> candidateReads;
+            vector<bool> candidateWrites;
+            uses(window, windowReads, windowWrites);
+            uses(candidate, candidateReads, candidateWrites);
+
+            vector<int> inputs;
+            for (int i = 0; i < STATE_SIZE; i++)
+            {
+                if (windowReads[i] || candidateReads[i] || windowWrites[i] != candidateWrites[i])
+                {
+                    inputs.emplace_back(i);
+                }
+            }
+
+            // The Z flag only has 2 values
+            states = 1;
+            for (int input : inputs)
+            {
+                if (input == Z)
+                {
+                    states *= 2;
+                }
+                else
+                {
+                    states *= 0x100;
+                }
+            }
+            if (states > (1LL << (8 * MAX_INPUT_BYTES + 1)))
+            {
+                return false;
+            }
+
+            for (long long combination = 0; combination < states; combination++)
+            {
+                array<int, STATE_SIZE> before = {};
+                long long rest = combination;
+                for (int input : inputs)
+                {
+                    int range = 0x100;
+                    if (input == Z)
+                    {
+                        range = 2;
+                    }
+                    before[input] = rest % range;
+                    rest /= range;
+                }
+
+                array<int, STATE_SIZE> after = before;
+                array<int, STATE_SIZE> candidateAfter = before;
+                execute(window, after);
+                execute(candidate, candidateAfter);
+                if (after != candidateAfter)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Marks what a sequence reads before it writes it, and what it writes
+        void uses(const vector<Op>& ops, vector<bool>& reads, vector<bool>& writes)
+        {
+            reads.assign(STATE_SIZE, false);
+            writes.assign(STATE_SIZE, false);
+            for (const Op& op : ops)
+            {
+                vector<int> read;
+                vector<int> written;
+                int operand = -1;
+                if (op.kind == 'm')
+                {
+                    operand = MEMORY + op.value;
+                }
+                else if (op.kind == 'k')
+                {
+                    operand = IMMEDIATES + op.value;
+                }
+
+                switch (op.opCode)
+                {
+                    case 0xA9:
+                    case 0xAD:
+                        read = {operand};
+                        written = {A};
+                        break;
+                    case 0xA2:
+                    case 0xAE:
+                        read = {operand};
+                        written = {X};
+                        break;
+                    case 0xA0:
+                    case 0xAC:
+                        read = {operand};
+                        written = {Y};
+                        break;
+                    case 0x8D:
+                        read = {A};
+                        written = {operand};
+                        break;
+                    case 0x6D:
+                        read = {A, operand};
+                        written = {A};
+                        break;
+                    case 0xEC:
+                        read = {X, operand};
+                        written = {Z};
+                        break;
+                    case 0xEE:
+                        read = {operand};
+                        written = {operand};
+                        break;
+                }
+
+                for (int item : read)
+                {
+                    if (item >= 0 && !writes[item])
+                    {
+                        reads[item] = true;
+                    }
+                }
+                for (int item : written)
+                {
+                    writes[item] = true;
+                }
+            }
+        }
+
+        // Runs a sequence on a state the same way the emulator would
+        void execute(const vector<Op>& ops, array<int, STATE_SIZE>& state)
+        {
+            for (const Op& op : ops)
+            {
+                int value = op.value;
+                if (op.kind == 'm')
+                {
+                    value = state[MEMORY + op.value];
+                }
+                else if (op.kind == 'k')
+                {
+                    value = state[IMMEDIATES + op.value];
+                }
+
+                switch (op.opCode)
+                {
+                    // LDA, LDX, LDY
+                    case 0xA9:
+                    case 0xAD:
+                        state[A] = value;
+                        break;
+                    case 0xA2:
+                    case 0xAE:
+                        state[X] = value;
+                        break;
+                    case 0xA0:
+                    case 0xAC:
+                        state[Y] = value;
+                        break;
+
+                    // STA
+                    case 0x8D:
+                        state[MEMORY + op.value] = state[A];
+                        break;
+
+                    // ADC
+                    case 0x6D:
+                        state[A] = (state[A] + value) & 0xFF;
+                        break;
+
+                    // CPX
+                    case 0xEC:
+                        state[Z] = state[X] == value;
+                        break;
+
+                    // INC
+                    case 0xEE:
+                        state[MEMORY + op.value] = (value + 1) & 0xFF;
+                        break;
+                }
+            }
+        }
+
+        // Size of a sequence in bytes and how many cycles it takes
+        int bytes(const vector<Op>& ops)
+        {
+            int total = 0;
+            for (const Op& op : ops)
+            {
+                total += OP_CODES.at(toHex(op.opCode)).size;
+            }
+            return total;
+        }
+
+        int cycles(const vector<Op>& ops)
+        {
+            int total = 0;
+            for (const Op& op : ops)
+            {
+                total += OP_CODES.at(toHex(op.opCode)).cycles;
+            }
+            return total;
+        }
+
+        // Operand of an op as it is written in a rule
+        string operandOf(const Op& op)
+        {
+            if (op.kind == '#')
+            {
+                return toHex(op.value);
+            }
+            return string(1, op.kind) + to_string(op.value);
+        }
+
+        // Identifies a window (op codes and operands)
+        string key(const vector<Op>& ops)
+        {
+            string result = "";
+            for (const Op& op : ops)
+            {
+                result += toHex(op.opCode) + " " + operandOf(op) + ",";
+            }
+            return result;
+        }
+
+        // Assembly for a sequence (LDA #01, ADC m0, etc)
+        string describe(const vector<Op>& ops)
+        {
+            if (ops.empty())
+            {
+                return "nothing";
+            }
+
+            string result = "";
+            for (const Op& op : ops)
+            {
+                if (result != "")
+                {
+                    result += ", ";
+                }
+                result += OP_CODES.at(toHex(op.opCode)).mnemonic + " ";
+                if (op.kind != 'm')
+                {
+                    result += "#";
+                }
+                result += operandOf(op);
+            }
+            return result;
+        }
+
+        // A sequence as a C++ initializer for the header
+        string initializer(const vector<Op>& ops)
+        {
+            string result = "{";
+            for (int i = 0, n = ops.size(); i < n; i++)
+            {
+                if (i > 0)
+                {
+                    result += ", ";
+                }
+                result += "{\"" + toHex(ops[i].opCode) + "\", \"" + operandOf(ops[i]) + "\"}";
+            }
+            return result + "}";
+        }
+
+        // Convert a byte to 2 digit hexadecimal
+        string toHex(const int value)
+        {
+            stringstream result;
+            result << uppercase << hex << setw(2) << setfill('0') << value;
+            return result.str();
+        }
+
+        // Logging function for the superoptimizer
+        void log(const string type, const string message)
+        {
+            // Only outputs if verbose mode is on or its INFO
+            if (VERBOSE || type != "DEBUG")
+            {
+                // For good looking formatting
+                const int spaceCount = 8;
+                const int spaces = spaceCount - type.length();
+                if (spaces <= 0)
+                {
+                    return;
+                }
+
+                // Print type
+                cout << type;
+
+                // Adds correct number of spaces so all the messages line up.
+                for (int i = 0; i < spaces; i++)
+                {
+                    cout << " ";
+                }
+                cout << "Superoptimizer - ";
+
+                cout << message << endl;
+            }
+        }
+};
+
+#endif
\ No newline at end of file
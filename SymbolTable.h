@@ -60,9 +60,34 @@ class SymbolTable
             return this->current;
         }
 
+        // Returns a deep copy of the Symbol Table
+        SymbolTable* copy()
+        {
+            SymbolTable* copied = new SymbolTable();
+            if (this->root != nullptr)
+            {
+                copied->root = copyHashNode(this->root, nullptr);
+                copied->current = copied->root;
+            }
+            return copied;
+        }
+
     private:
         HashNode* root;
         HashNode* current;
+
+        // Copies a HashNode (with its hash table) and every scope under it
+        HashNode* copyHashNode(HashNode* node, HashNode* parent)
+        {
+            HashNode* copied = new HashNode(*node);
+            copied->setParent(parent);
+            for (HashNode* child : node->getChildren())
+            {
+                copied->removeChild(child);
+                copied->addChild(copyHashNode(child, copied));
+            }
+            return copied;
+        }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef TARGET_H
+#define TARGET_H
+
+using namespace std;
+
+// Describes the machine that Code Gen is generating an image for
+class Target
+{
+    public:
+        // Constructor for a target profile
+        Target(const string newName, const int newMemorySize)
+        {
+            this->name = newName;
+            this->memorySize = newMemorySize;
+        }
+
+        // Default profile (the original 256 byte runtime environment)
+        Target()
+        {
+            this->name = "256B";
+            this->memorySize = 0x100;
+        }
+
+        // Finds a profile by its name (4K, 32K, etc), returns false if it doesn't exist
+        static bool find(const string profileName, Target& result)
+        {
+            for (Target profile : profiles())
+            {
+                if (profile.getName() == profileName)
+                {
+                    result = profile;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // List of every profile that can be selected
+        static vector<Target> profiles()
+        {
+            return {Target("256B", 0x100), Target("4K", 0x1000), Target("32K", 0x8000), Target("64K", 0x10000)};
+        }
+
+        // Getters
+        string getName()
+        {
+            return this->name;
+        }
+
+        int getMemorySize()
+        {
+            return this->memorySize;
+        }
+
+        // Whether or not addresses need the high byte (anything bigger than the zero page)
+        bool isPaged()
+        {
+            return this->memorySize > 0x100;
+        }
+
+        // Last byte in memory, used as a scratch cell and always restored to 0x00
+        int getScratchAddress()
+        {
+            return this->memorySize - 1;
+        }
+
+        // Strings live in the top page of memory so a single byte can point to them
+        int getHeapPage()
+        {
+            return (this->memorySize - 1) >> 8;
+        }
+
+        // First address of the page that holds the heap
+        int getHeapStart()
+        {
+            return getHeapPage() << 8;
+        }
+
+    private:
+        // Members
+        string name;
+        int memorySize;
+};
+
+#endif
\ No newline at end of file
@@ -84,12 +84,44 @@ class Tree
             return this->current;
         }
 
+        // Returns a deep copy of the Tree (leaves share their tokens with the original)
+        Tree* copy()
+        {
+            Tree* copied = new Tree();
+            if (this->root != nullptr)
+            {
+                copied->root = copyNode(this->root, nullptr);
+                copied->current = copied->root;
+                copied->mostRecentNode = copied->root;
+            }
+            return copied;
+        }
+
     private:
         Node* root;
         Node* current;
 
         // Pointer for the most recent Node (used for linking tokens to leaf nodes)
         Node* mostRecentNode;
+
+        // Copies a Node and everything under it
+        Node* copyNode(Node* node, Node* parent)
+        {
+            Node* copied = new Node();
+            copied->setName(node->getName());
+            copied->setParent(parent);
+            copied->linkToken(node->getToken());
+            if (node->isLeaf())
+            {
+                copied->setToLeaf();
+            }
+
+            for (Node* child : node->getChildren())
+            {
+                copied->addChild(copyNode(child, copied));
+            }
+            return copied;
+        }
 };
 
 #endif
\ No newline at end of file
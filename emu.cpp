@@ -0,0 +1,148 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <regex>
+#include <unordered_map>
+#include <iomanip>
+#include <array>
+#include <algorithm>
+
+#include "Verbose.h"
+#include "Token.h"
+#include "Node.h"
+#include "Instruction.h"
+#include "Emulator.h"
+
+using namespace std;
+
+// Prototypes for functions in file
+void log(const string type, const string message);
+vector<pair<int, vector<string>>> readImages(const string& input);
+
+
+// Runs the hex dumps printed by the compiler (or a file with just a hex dump) in the emulator
+int main(int argc, char* argv[])
+{
+    // File IO
+    if (argc < 2)
+    {
+        cout << "Arguments were incorrect. Use command 'make emu FILE='filename''." << endl;
+        return 1;
+    }
+
+    ifstream file(argv[1]);
+    if (!file)
+    {
+        cout << "File failed to open." << endl;
+        return 1;
+    }
+
+    // Copies all characters from the file to the output string
+    string output((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    // Close file
+    file.close();
+
+    vector<pair<int, vector<string>>> images = readImages(output);
+    if (images.empty())
+    {
+        log("ERROR", "No hex dump found in " + string(argv[1]));
+        return 1;
+    }
+
+    // Run each program
+    for (auto& image : images)
+    {
+        cout << endl;
+        Emulator currentEmulator = Emulator(image.second);
+        bool finished = currentEmulator.run();
+        currentEmulator.printResults(image.first, finished);
+    }
+}
+
+// Logging function for the emulator program
+void log(const string type, const string message)
+{
+    // Only outputs if verbose mode is on or its INFO
+    if (VERBOSE || type != "DEBUG")
+    {
+        // For good looking formatting
+        const int spaceCount = 8;
+        const int spaces = spaceCount - type.length();
+        if (spaces <= 0)
+        {
+            return;
+        }
+
+        // Print type
+        cout << type;
+
+        // Adds correct number of spaces so all the messages line up.
+        for (int i = 0; i < spaces; i++)
+        {
+            cout << " ";
+        }
+        cout << "Emulator - ";
+
+        cout << message << endl;
+    }
+}
+
+// Collects every hex dump in the output along with the number of its program
+// A dump is a run of lines that only have hex bytes, numbered by the Code Gen line before it (or by its position if there isn't one)
+vector<pair<int, vector<string>>> readImages(const string& input)
+{
+    const regex programREGEX = regex(R"(Code Generation for Program #(\d+))");
+    const regex hexREGEX = regex(R"(^([0-9A-F]{2} ?)+$)");
+
+    vector<pair<int, vector<string>>> images;
+    vector<string> bytes;
+    int programNumber = 0;
+
+    stringstream lines(input);
+    string line;
+    while (true)
+    {
+        bool more = (bool)getline(lines, line);
+
+        // Remove trailing whitespace
+        line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+
+        smatch match;
+        if (more && regex_match(line, hexREGEX))
+        {
+            stringstream hexBytes(line);
+            string hexByte;
+            while (hexBytes >> hexByte)
+            {
+                bytes.emplace_back(hexByte);
+            }
+            continue;
+        }
+
+        // Anything else ends the current dump
+        if (!bytes.empty())
+        {
+            if (programNumber == 0)
+            {
+                programNumber = images.size() + 1;
+            }
+            images.emplace_back(programNumber, bytes);
+            bytes.clear();
+            programNumber = 0;
+        }
+
+        if (!more)
+        {
+            break;
+        }
+
+        if (regex_search(line, match, programREGEX))
+        {
+            programNumber = stoi(match[1]);
+        }
+    }
+
+    return images;
+}
\ No newline at end of file
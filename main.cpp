@@ -6,8 +6,21 @@
 #include <unordered_map>
 #include <iomanip>
 #include <array>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <climits>
 
 #include "Verbose.h"
+#include "Target.h"
+#include "Options.h"
 #include "Token.h"
 #include "Tree.h"
 #include "SymbolTable.h"
@@ -15,123 +28,403 @@
 #include "Lexer.h"
 #include "Parser.h"
 #include "SemanticAnalyzer.h"
+#include "ConstantFolder.h"
+#include "ConstantPropagator.h"
+#include "DeadCodeEliminator.h"
+#include "CommonSubexpressions.h"
+#include "LoopInvariantMotion.h"
+#include "Instruction.h"
+#include "RegisterState.h"
+#include "SuperRules.h"
+#include "Peephole.h"
+#include "IR.h"
+#include "IRBuilder.h"
+#include "DataFlow.h"
+#include "SelectionRules.h"
+#include "IRSelector.h"
 #include "CodeGen.h"
+#include "Emulator.h"
+#include "Profiler.h"
+#include "SourceMap.h"
+#include "Listing.h"
+#include "Optimizer.h"
+#include "Compiler.h"
+#include "BatchRunner.h"
+#include "DiffHarness.h"
+#include "Superoptimizer.h"
 
 using namespace std;
 
 // Prototypes for functions in file
 void log(const string type, const string message);
 vector<string> splitPrograms(const string& input, const char delimiter);
+bool readPrograms(const string path, const char delimiter, vector<string>& programs);
+int runBatch(const string path, Options options);
+int runDiff(const string path, Options options);
+int runSuperopt(const string path, Options options);
+vector<string> listFiles(const string path);
 
 
 int main(int argc, char* argv[]) 
 {
     // File IO
-    if (argc != 2)
+    if (argc < 2)
     {
         cout << "Arguments were incorrect. Use command 'make FILE='filename''." << endl;
         return 1;
     }
 
-    ifstream file(argv[1]);
-    if (!file)
+    // Optional flags after the file name
+    Options options;
+    for (int i = 2; i < argc; i++)
     {
-        cout << "File failed to open." << endl;
-        return 1;
+        string flag = argv[i];
+
+        // Memory profile for Code Gen (256B, 4K, 32K, 64K)
+        if (flag.rfind("--mem=", 0) == 0)
+        {
+            Target target;
+            if (!Target::find(flag.substr(6), target))
+            {
+                cout << "Unknown memory profile '" << flag.substr(6) << "'. Use 256B, 4K, 32K, or 64K." << endl;
+                return 1;
+            }
+            options.setTarget(target);
+        }
+        // Optimization level (-O0, -O1, -O2, -Os)
+        else if (flag.rfind("-O", 0) == 0)
+        {
+            if (!options.setLevel(flag.substr(2)))
+            {
+                cout << "Unknown optimization level '" << flag << "'. Use -O0, -O1, -O2, or -Os." << endl;
+                return 1;
+            }
+        }
+        // Turn single passes on or off (--enable=peephole, --disable=peephole)
+        else if (flag.rfind("--enable=", 0) == 0 || flag.rfind("--disable=", 0) == 0)
+        {
+            bool enabled = flag[2] == 'e';
+            string pass = flag.substr(flag.find('=') + 1);
+            if (!options.setPass(pass, enabled))
+            {
+                cout << "Unknown optimization pass '" << pass << "'." << endl;
+                return 1;
+            }
+        }
+        // Run the generated code in the emulator
+        else if (flag == "--run")
+        {
+            options.setRun(true);
+        }
+        // Print an annotated listing of the generated code
+        else if (flag == "--listing")
+        {
+            options.setListing(true);
+        }
+        // Generate code through the three-address IR (--ir), and print the IR too (--dump-ir)
+        else if (flag == "--ir")
+        {
+            options.setIR(true);
+        }
+        else if (flag == "--dump-ir")
+        {
+            options.setDumpIR(true);
+        }
+        // What instruction selection on the IR path makes cheapest (--cost=size, --cost=speed)
+        else if (flag.rfind("--cost=", 0) == 0)
+        {
+            if (!options.setCostModel(flag.substr(7)))
+            {
+                cout << "Unknown cost model '" << flag.substr(7) << "'. Use size or speed." << endl;
+                return 1;
+            }
+        }
+        // Run the generated code in the emulator and profile it (--profile, or --profile=file for the collapsed stacks)
+        else if (flag == "--profile" || flag.rfind("--profile=", 0) == 0)
+        {
+            string path = "profile.folded";
+            if (flag.find('=') != string::npos)
+            {
+                path = flag.substr(flag.find('=') + 1);
+            }
+            options.setProfilePath(path);
+        }
+        // Write a source map from code addresses to the source (--map, or --map=file)
+        else if (flag == "--map" || flag.rfind("--map=", 0) == 0)
+        {
+            string path = "sourcemap.txt";
+            if (flag.find('=') != string::npos)
+            {
+                path = flag.substr(flag.find('=') + 1);
+            }
+            options.setSourceMapPath(path);
+        }
+        // Compile every program in a file or directory and run them on a pool of workers (--batch, or --batch=file for the report)
+        else if (flag == "--batch" || flag.rfind("--batch=", 0) == 0)
+        {
+            string path = "report.json";
+            if (flag.find('=') != string::npos)
+            {
+                path = flag.substr(flag.find('=') + 1);
+            }
+            options.setBatchPath(path);
+        }
+        // Compare every program in a file or directory at other optimization settings to -O0 (--diff, or --diff=file for the report)
+        else if (flag == "--diff" || flag.rfind("--diff=", 0) == 0)
+        {
+            string path = "diff.json";
+            if (flag.find('=') != string::npos)
+            {
+                path = flag.substr(flag.find('=') + 1);
+            }
+            options.setDiffPath(path);
+        }
+        // Search every program in a file or directory for windows of instructions to superoptimize (--superopt, or --superopt=file for the header)
+        else if (flag == "--superopt" || flag.rfind("--superopt=", 0) == 0)
+        {
+            string path = "SuperRules.h";
+            if (flag.find('=') != string::npos)
+            {
+                path = flag.substr(flag.find('=') + 1);
+            }
+            options.setSuperoptPath(path);
+        }
+        // Number of workers for a batch or differential run (--jobs=4)
+        else if (flag.rfind("--jobs=", 0) == 0)
+        {
+            options.setJobs(atoi(flag.substr(7).c_str()));
+        }
+        // Most instructions and cycles the emulator runs a program for (--steps=100000, --cycles=500000)
+        else if (flag.rfind("--steps=", 0) == 0)
+        {
+            options.setBudget(atoll(flag.substr(8).c_str()), options.getCycleBudget());
+        }
+        else if (flag.rfind("--cycles=", 0) == 0)
+        {
+            options.setBudget(options.getStepBudget(), atoll(flag.substr(9).c_str()));
+        }
+        else
+        {
+            cout << "Unknown flag '" << flag << "'." << endl;
+            return 1;
+        }
     }
 
-    // Copies all characters from the file to the code string
-    string code((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    // Start the profile over (each program adds its stacks to it)
+    if (options.getProfilePath() != "")
+    {
+        ofstream profileFile(options.getProfilePath());
+    }
 
-    // Close file
-    file.close();
+    // Start the source map over (each program adds its entries to it)
+    if (options.getSourceMapPath() != "")
+    {
+        ofstream sourceMapFile(options.getSourceMapPath());
+    }
 
-    // Remove trailing whitespace
-    code.erase(code.find_last_not_of(" \t\n\r\f\v") + 1);
+    if (options.getBatchPath() != "")
+    {
+        return runBatch(argv[1], options);
+    }
+    if (options.getDiffPath() != "")
+    {
+        return runDiff(argv[1], options);
+    }
+    if (options.getSuperoptPath() != "")
+    {
+        return runSuperopt(argv[1], options);
+    }
 
     // Vector that stores programs separated with $
     char delimiter = '$';
-    vector<string> programs = splitPrograms(code, delimiter);
+    vector<string> programs;
+    if (!readPrograms(argv[1], delimiter, programs))
+    {
+        cout << "File failed to open." << endl;
+        return 1;
+    }
 
     // Compile each program
     for (int i = 0, size = programs.size(); i < size; i++)
     {
-        cout << endl;
-        int errors = 0;
-        
-        // LEXER
-        Lexer currentLex = Lexer(i + 1, programs[i], delimiter);
-        auto lexResult = currentLex.tokenize();
-        vector<Token> tokens = lexResult.first;
-        errors = lexResult.second;
+        Compiler currentCompiler = Compiler(i + 1, programs[i], delimiter, options);
+        currentCompiler.compile();
+    }
+}
 
-        cout << endl;
+// Compiles every program in a file (or every file in a directory) and runs the images on a pool of workers, then writes the report
+int runBatch(const string path, Options options)
+{
+    vector<string> files = listFiles(path);
+    BatchRunner runner = BatchRunner(options.getJobs(), options.getStepBudget(), options.getCycleBudget());
+    char delimiter = '$';
 
-        // PARSER
-        if (errors > 0 || tokens.size() == 0)
+    // Compiler output is only noise in a batch, so it's thrown away while compiling
+    int programCount = 0;
+    streambuf* console = cout.rdbuf(nullptr);
+    for (const string& file : files)
+    {
+        vector<string> programs;
+        if (!readPrograms(file, delimiter, programs))
         {
-            log("INFO", "Parsing for Program #" + to_string(i + 1) + " skipped due to Lex error(s)");
+            runner.add(file, 0, "file error", {});
             continue;
         }
 
-        Parser currentParse = Parser(i + 1, tokens, delimiter);
-        currentParse.parse();
-        errors = currentParse.getErrors();
+        for (int i = 0, size = programs.size(); i < size; i++)
+        {
+            Compiler currentCompiler = Compiler(i + 1, programs[i], delimiter, options);
+            string result = currentCompiler.compile();
+            runner.add(file, i + 1, result, currentCompiler.getBuild().image);
+            programCount++;
+        }
+    }
+    cout.rdbuf(console);
+    cout.clear();
 
-        cout << endl;
+    log("INFO", "Compiled " + to_string(programCount) + " program(s) from " + to_string(files.size()) + " file(s)");
+    runner.run();
+    runner.printSummary();
+    if (!runner.writeReport(options.getBatchPath()))
+    {
+        return 1;
+    }
+    return 0;
+}
 
-        // CST
-        if (errors > 0)
+// Compiles every program in a file (or every file in a directory) at every variant the diff harness has, then compares them to -O0
+// Returns 1 if any variant didn't match
+int runDiff(const string path, Options options)
+{
+    vector<string> files = listFiles(path);
+    char delimiter = '$';
+    DiffHarness harness = DiffHarness(options, delimiter);
+
+    for (const string& file : files)
+    {
+        vector<string> programs;
+        if (!readPrograms(file, delimiter, programs))
         {
-            log("INFO", "CST for Program #" + to_string(i + 1) + " skipped due to Parse error(s)");
-            currentParse.deleteCST();
+            log("ERROR", "Could not read " + file);
             continue;
         }
 
-        Tree* currentCST = currentParse.getCST();
-        
-        if (VERBOSE)
+        for (int i = 0, size = programs.size(); i < size; i++)
         {
-            log("INFO", "CST for Program #" + to_string(i + 1));
-            currentParse.printCST();
+            harness.add(file, i + 1, programs[i]);
         }
+    }
 
-        // SEMANTIC ANALYSIS
-        SemanticAnalyzer currentAnalyzer = SemanticAnalyzer(i + 1, currentCST);
-        currentAnalyzer.generate();
-        currentAnalyzer.traverseSymbolTable();
+    harness.run();
+    harness.printSummary();
+    if (!harness.writeReport(options.getDiffPath()) || !harness.matched())
+    {
+        return 1;
+    }
+    return 0;
+}
 
-        cout << endl;
+// Compiles every program in a file (or every file in a directory) at each level without the peephole optimizer,
+// then superoptimizes the windows of instructions that show up the most and writes the rules to a header
+int runSuperopt(const string path, Options options)
+{
+    vector<string> files = listFiles(path);
+    char delimiter = '$';
+    Superoptimizer superoptimizer = Superoptimizer(2);
 
-        currentAnalyzer.printAST();
-        errors = currentAnalyzer.getErrors();
+    // Windows come from the templates as Code Gen emits them at every level, before the peephole optimizer touches them
+    vector<Options> settings;
+    for (string level : {"0", "1", "2", "s"})
+    {
+        Options setting = options;
+        setting.setLevel(level);
+        setting.setPass("peephole", false);
+        settings.emplace_back(setting);
+    }
 
-        if (errors > 0)
+    // Compiler output is only noise here, so it's thrown away while compiling
+    int programCount = 0;
+    streambuf* console = cout.rdbuf(nullptr);
+    for (const string& file : files)
+    {
+        vector<string> programs;
+        if (!readPrograms(file, delimiter, programs))
         {
-            log("INFO", "Symbol Table for Program #" + to_string(i + 1) + " skipped due to Semantic Analysis error(s)");
-            currentParse.deleteCST();
-            currentAnalyzer.deleteAST();
-            currentAnalyzer.deleteSymbolTable();
             continue;
         }
-        currentAnalyzer.printSymbolTable();
 
-        Tree* currentAST = currentAnalyzer.getAST();
-        SymbolTable* currentSymbolTable = currentAnalyzer.getSymbolTable();
+        for (int i = 0, size = programs.size(); i < size; i++)
+        {
+            Compiler currentCompiler = Compiler(i + 1, programs[i], delimiter, options);
+            currentCompiler.compileEach(settings);
+            for (Build& build : currentCompiler.getBuilds())
+            {
+                superoptimizer.add(build.code);
+            }
+            programCount++;
+        }
+    }
+    cout.rdbuf(console);
+    cout.clear();
+
+    log("INFO", "Compiled " + to_string(programCount) + " program(s) from " + to_string(files.size()) + " file(s)");
+    superoptimizer.search();
+    superoptimizer.printSummary();
+    if (!superoptimizer.writeHeader(options.getSuperoptPath()))
+    {
+        return 1;
+    }
+    return 0;
+}
 
-        cout << endl;
+// Files to compile for a path (every file in a directory in name order so reports can be compared, or just the path)
+vector<string> listFiles(const string path)
+{
+    vector<string> files;
+    if (filesystem::is_directory(path))
+    {
+        for (const auto& entry : filesystem::directory_iterator(path))
+        {
+            if (entry.is_regular_file())
+            {
+                files.emplace_back(entry.path().string());
+            }
+        }
+        sort(files.begin(), files.end());
+    }
+    else
+    {
+        files.emplace_back(path);
+    }
+    return files;
+}
 
-        // CODE GEN
-        CodeGen currentCodeGen = CodeGen(i + 1, currentAST, currentSymbolTable);
-        currentCodeGen.generate();
-        currentCodeGen.print();
+// Reads a file and splits it into its programs, returns false if it couldn't be opened
+bool readPrograms(const string path, const char delimiter, vector<string>& programs)
+{
+    ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Copies all characters from the file to the code string
+    string code((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
 
-        // PROPER MEMORY MANAGEMENT
-        currentParse.deleteCST();
-        currentAnalyzer.deleteAST();
-        currentAnalyzer.deleteSymbolTable();
+    // Close file
+    file.close();
 
+    // Remove trailing whitespace
+    code.erase(code.find_last_not_of(" \t\n\r\f\v") + 1);
+
+    // A file with nothing in it has no programs
+    if (code.empty())
+    {
+        return true;
     }
+
+    programs = splitPrograms(code, delimiter);
+    return true;
 }
 
 // Logging function for overall Compiler